@@ -27,6 +27,7 @@
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
 #include "cinn/optim/ir_copy.h"
+#include "cinn/utils/multi_threading.h"
 #include "cinn/utils/sized_multi_set.h"
 
 namespace cinn {
@@ -79,7 +80,9 @@ std::vector<SearchState> EvolutionarySearch::RandomInitSketch(int num) {
   return search_space_->GetRandomInitialSketch(num);
 }
 
-SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const SearchState& state2) {
+SearchState EvolutionarySearch::CrossOver(const SearchState& state1,
+                                          const SearchState& state2,
+                                          const std::vector<bool>& from_state1) {
   // TODO(CtfGo): tracing CrossOver with IRSchedule
   std::vector<ir::Expr> cross_over_exprs;
   std::vector<ir::Expr> father_exprs = state1.ir_schedule.GetModule().GetExprs();
@@ -87,9 +90,10 @@ SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const Searc
 
   CHECK_EQ(father_exprs.size(), mother_exprs.size())
       << "CrossOver ModuleExpr in EvolutionarySearch must have same number of AST";
+  CHECK_EQ(father_exprs.size(), from_state1.size());
 
   for (size_t i = 0; i < father_exprs.size(); ++i) {
-    if (rand() % 2 == 0) {
+    if (from_state1[i]) {
       cross_over_exprs.push_back(optim::IRCopy(father_exprs[i]));
     } else {
       cross_over_exprs.push_back(optim::IRCopy(mother_exprs[i]));
@@ -107,14 +111,30 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
   }
   std::vector<SearchState> evolution(population);
 
+  // all the random choices are drawn on the calling thread in the same order as a sequential cross over, so that a
+  // seeded search stays reproducible
+  std::vector<std::pair<int, int>> parents;
+  std::vector<std::vector<bool>> from_first_parent;
   for (int i = 0; i < cross_over_num; ++i) {
     int first_rand_idx  = rand() % generation_num;
     int second_rand_idx = rand() % generation_num;
     while (first_rand_idx == second_rand_idx) {
       second_rand_idx = rand() % generation_num;
     }
-    evolution.push_back(CrossOver(population[first_rand_idx], population[second_rand_idx]));
+    parents.emplace_back(first_rand_idx, second_rand_idx);
+    size_t num_exprs = population[first_rand_idx].ir_schedule.GetModule().GetExprs().size();
+    from_first_parent.emplace_back(num_exprs);
+    for (size_t j = 0; j < num_exprs; ++j) {
+      from_first_parent.back()[j] = rand() % 2 == 0;
+    }
   }
+  // copying the ASTs dominates the cross over, which is independent between children
+  std::vector<SearchState> children(parents.size());
+  utils::parallel_for(0, parents.size(), [&](int index) {
+    children[index] =
+        CrossOver(population[parents[index].first], population[parents[index].second], from_first_parent[index]);
+  });
+  evolution.insert(evolution.end(), children.begin(), children.end());
 
   utils::SizedMultiSet<SearchState> evolution_with_cost(ret_num);
   for (size_t i = 0; i < evolution.size(); ++i) {
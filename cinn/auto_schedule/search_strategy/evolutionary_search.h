@@ -88,7 +88,8 @@ class EvolutionarySearch {
 
   std::vector<SearchState> RandomInitSketch(int num);
 
-  SearchState CrossOver(const SearchState& state1, const SearchState& state2);
+  // take the i-th AST of the child from state1 if from_state1[i] is true, otherwise from state2
+  SearchState CrossOver(const SearchState& state1, const SearchState& state2, const std::vector<bool>& from_state1);
 
   std::vector<SearchState> Evolve(const std::vector<SearchState>& population, int cross_over_num, int ret_num);
 
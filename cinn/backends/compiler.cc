@@ -131,6 +131,16 @@ void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86
 
 void Compiler::ExportObject(const std::string& path) { engine_->ExportObject(path); }
 
+std::string Compiler::GetObjectCode() const {
+  CHECK(target_.arch == Target::Arch::X86) << "Only the object code of X86 module can be got";
+  return engine_->GetObjectCode();
+}
+
+void Compiler::LinkObject(const std::string& object_code) {
+  CHECK(target_.arch == Target::Arch::X86) << "Only the object code of X86 module can be linked";
+  engine_->AddObject(object_code);
+}
+
 void* Compiler::Lookup(absl::string_view fn_name) {
   CHECK(engine_);
   if (engine_->Lookup(fn_name) != nullptr) {
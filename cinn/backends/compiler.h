@@ -43,6 +43,14 @@ class Compiler final {
 
   void ExportObject(const std::string& path);
 
+  //! Get the object code of the compiled X86 module.
+  std::string GetObjectCode() const;
+
+  /**
+   * Link the object code got by GetObjectCode, which skips lowering and codegen.
+   */
+  void LinkObject(const std::string& object_code);
+
   std::string GetSourceCode(const ir::Module& module);
 
   void BuildDefault(const ir::Module& module);
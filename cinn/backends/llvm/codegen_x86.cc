@@ -81,6 +81,16 @@ void CodeGenX86::CreateParallelLaunch(Expr body, int num_task) {
   llvm::Function* f =
       llvm::Function::Create(ftype_parallel_lambda, llvm::Function::PrivateLinkage, "__parallel_lambda", m_);
   std::vector<std::string> vars = optim::CollectUndefinedVars(&body);
+  // the tasks of a dynamic or guided parallel loop share an iteration counter reset by each launch
+  std::string counter_name;
+  auto* parallel_for = body.As<ir::For>();
+  if (parallel_for && parallel_for->parallel_info().is_dynamic()) {
+    counter_name  = common::UniqName("parallel_counter");
+    auto* counter = CreateEntryAlloca(ll_int32_ty(), counter_name);
+    b_->CreateStore(ll_const_int32(0), counter);
+    SetVar(counter_name, counter);
+    vars.push_back(counter_name);
+  }
   uint64_t nbytes;
   auto* data = PackVars(vars, &nbytes);
 
@@ -108,7 +118,8 @@ void CodeGenX86::CreateParallelLaunch(Expr body, int num_task) {
   par_env.num_task   = ir::Var(num_task_name, Int(32));
   SetVar(task_id_name, task_id);
   SetVar(num_task_name, penv);
-  par_env.penv = penv;
+  par_env.penv         = penv;
+  par_env.counter_name = counter_name;
   std::swap(f_, f);
   std::swap(parallel_env_, par_env);
   this->Visit(&body);
@@ -119,23 +130,84 @@ void CodeGenX86::CreateParallelLaunch(Expr body, int num_task) {
   std::swap(parallel_env_, par_env);
   std::swap(f_, f);
   CHECK_NE(par_env.parallel_loop_count, 0) << "find no parallel loop within parallel launch";
+  if (!counter_name.empty()) {
+    symbol_table_->Erase(counter_name);
+  }
   b_->SetInsertPoint(launch_end);
 }
 
+llvm::AllocaInst* CodeGenX86::CreateEntryAlloca(llvm::Type* type, const std::string& name) {
+  llvm::IRBuilderBase::InsertPointGuard guard(*b_);
+  auto* func = b_->GetInsertBlock()->getParent();
+  b_->SetInsertPoint(&func->getEntryBlock(), func->getEntryBlock().getFirstInsertionPt());
+  return b_->CreateAlloca(type, nullptr, name);
+}
+
+void CodeGenX86::CreateDynamicParallelFor(const ir::For* op) {
+  CHECK(!parallel_env_.counter_name.empty()) << "The dynamic parallel loop should be launched with a counter";
+  auto* int_ptr_ty       = ll_int32_ty()->getPointerTo();
+  auto* ftype_next_chunk = llvm::FunctionType::get(
+      ll_int32_ty(), {int_ptr_ty, ll_int32_ty(), ll_int32_ty(), ll_int32_ty(), ll_int32_ty(), int_ptr_ty}, false);
+  auto* next_chunk_callee = llvm::dyn_cast<llvm::Function>(
+      m_->getOrInsertFunction(runtime::intrinsic::parallel_next_chunk, ftype_next_chunk).getCallee());
+  next_chunk_callee->setCallingConv(llvm::CallingConv::C);
+
+  auto& info      = op->parallel_info();
+  auto* end_ptr   = CreateEntryAlloca(ll_int32_ty(), "chunk_end");
+  auto* counter   = GetVar(parallel_env_.counter_name);
+  auto* extent    = Visit(&op->extent);
+  auto* grain     = llvm_int32_constant(info.grain_size);
+  auto* is_guided = llvm_int32_constant(info.schedule == ir::ParallelSchedule::Guided);
+
+  auto* func      = b_->GetInsertBlock()->getParent();
+  auto* fetch_bb  = llvm::BasicBlock::Create(b_->getContext(), "chunk_fetch", func);
+  auto* chunk_bb  = llvm::BasicBlock::Create(b_->getContext(), "chunk_body", func);
+  auto* finish_bb = llvm::BasicBlock::Create(b_->getContext(), "chunk_finish", func);
+  b_->CreateBr(fetch_bb);
+
+  // fetch the next chunk [begin, end) until begin reaches the extent
+  b_->SetInsertPoint(fetch_bb);
+  auto* begin =
+      b_->CreateCall(next_chunk_callee, {counter, extent, grain, parallel_env_.penv, is_guided, end_ptr}, "begin");
+  b_->CreateCondBr(b_->CreateICmpSLT(begin, extent), chunk_bb, finish_bb);
+
+  b_->SetInsertPoint(chunk_bb);
+  auto* end       = Load(end_ptr, "end");
+  auto begin_name = common::UniqName("chunk_begin");
+  auto end_name   = common::UniqName("chunk_end");
+  SetVar(begin_name, begin);
+  SetVar(end_name, end);
+  auto chunk_for = ir::For::Make(op->loop_var,
+                                 ir::Var(begin_name, Int(32)),
+                                 ir::Var(end_name, Int(32)),
+                                 op->for_type(),
+                                 op->device_api,
+                                 op->body,
+                                 op->vectorize_info());
+  CreateSerialFor(chunk_for.As<ir::For>());
+  symbol_table_->Erase(begin_name);
+  symbol_table_->Erase(end_name);
+  b_->CreateBr(fetch_bb);
+
+  b_->SetInsertPoint(finish_bb);
+}
+
 llvm::Value* CodeGenX86::Visit(const ir::For* op) {
   if (op->is_parallel()) {
     VLOG(3) << "parallel forloop";
     if (parallel_env_.penv == nullptr) {
-      CreateParallelLaunch(
-          ir::For::Make(
-              op->loop_var, op->min, op->extent, op->for_type(), op->device_api, op->body, op->vectorize_info()),
-          0);
+      auto parallel_for = ir::For::Make(
+          op->loop_var, op->min, op->extent, op->for_type(), op->device_api, op->body, op->vectorize_info());
+      parallel_for.As<ir::For>()->set_parallel_info(op->parallel_info());
+      CreateParallelLaunch(parallel_for, 0);
     } else {
       Expr num_task = parallel_env_.num_task;
       Expr task_id  = parallel_env_.task_id;
       CHECK(!parallel_env_.in_parallel_loop) << "Nested parallel loop is not supported, try to fuse them instead";
       parallel_env_.in_parallel_loop = true;
-      if (parallel_env_.stride_pattern) {
+      if (op->parallel_info().is_dynamic()) {
+        CreateDynamicParallelFor(op);
+      } else if (parallel_env_.stride_pattern) {
         auto new_for = ir::For::Make(
             op->loop_var, task_id, op->extent, op->for_type(), op->device_api, op->body, op->vectorize_info());
         auto for_node = new_for.As<ir::For>();
@@ -43,11 +43,17 @@ class CodeGenX86 : public CodeGenLLVM {
     bool in_parallel_loop{false};
     int parallel_loop_count{0};
     llvm::Value* penv{nullptr};
+    // name of the iteration counter shared by the tasks of a dynamic or guided parallel loop
+    std::string counter_name;
   };
 
   llvm::Value* ParallelLaunch();
   // Create parallel launch
   void CreateParallelLaunch(Expr body, int num_task);
+  // Create the loop of a task fetching chunks of a dynamic or guided parallel loop until the iterations are exhausted
+  void CreateDynamicParallelFor(const ir::For* op);
+  // Create an alloca in the entry block of the current function
+  llvm::AllocaInst* CreateEntryAlloca(llvm::Type* type, const std::string& name);
 
   llvm::Value* PackVars(const std::vector<std::string>& vars, uint64_t* num_bytes);
   void UnpackVars(const std::vector<std::string>& vars, llvm::Value* data);
@@ -16,9 +16,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "cinn/backends/llvm/simple_jit.h"
 #include "cinn/cinn.h"
 #include "cinn/common/test_helper.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/runtime/cinn_runtime.h"
 
 namespace cinn {
@@ -69,5 +72,51 @@ TEST(Vectorize, basic) {
   }
 }
 
+TEST(ParallelSchedule, dynamic_and_guided) {
+  // the extent is not divisible by the grain sizes nor the number of tasks
+  Expr M(1001), N(16);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+
+  auto C = Compute(
+      {M, N}, [&](Expr i, Expr j) { return A(i, j) * B(i, j); }, "C");
+  auto stages = CreateStages({C});
+  stages[C]->Parallel(0);
+
+  std::vector<ir::ParallelInfo> infos = {ir::ParallelInfo(ir::ParallelSchedule::Dynamic, 7),
+                                         ir::ParallelInfo(ir::ParallelSchedule::Guided, 3)};
+  for (auto& info : infos) {
+    auto fn             = Lower("fn", stages, {A, B, C});
+    auto parallel_loops = ir::CollectIRNodes(
+        fn->body, [](const Expr* x) { return x->As<ir::For>() && x->As<ir::For>()->is_parallel(); });
+    ASSERT_EQ(parallel_loops.size(), 1U);
+    Expr parallel_loop = *parallel_loops.begin();
+    parallel_loop.As<ir::For>()->set_parallel_info(info);
+
+    Module::Builder builder("module", common::DefaultHostTarget());
+    builder.AddFunction(fn);
+    auto jit = SimpleJIT::Create();
+    jit->Link(builder.Build());
+    auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn"));
+
+    auto* A_buf = common::BufferBuilder(Float(32), {1001, 16}).set_random().Build();
+    auto* B_buf = common::BufferBuilder(Float(32), {1001, 16}).set_random().Build();
+    auto* C_buf = common::BufferBuilder(Float(32), {1001, 16}).set_zero().Build();
+    auto args   = common::ArgsBuilder().Add(A_buf).Add(B_buf).Add(C_buf).Build();
+
+    // the counter is reset by each launch
+    for (int repeat = 0; repeat < 3; ++repeat) {
+      fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+      auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+      auto* B_data = reinterpret_cast<float*>(B_buf->memory);
+      auto* C_data = reinterpret_cast<float*>(C_buf->memory);
+      for (int i = 0; i < C_buf->num_elements(); i++) {
+        ASSERT_NEAR(A_data[i] * B_data[i], C_data[i], 1e-5);
+      }
+      std::fill(C_data, C_data + C_buf->num_elements(), 0.f);
+    }
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -0,0 +1,270 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/disk_object_cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/SHA256.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+DECLARE_string(cinn_jit_cache_dir);
+DECLARE_int32(cinn_jit_cache_max_mb);
+
+namespace cinn::backends {
+namespace {
+
+constexpr char kMagic[]        = "CINNOBJ2";
+constexpr size_t kMagicLen     = sizeof(kMagic) - 1;
+constexpr char kObjectSuffix[] = ".o";
+constexpr char kTmpInfix[]     = ".tmp.";
+constexpr uint64_t kFnvPrime   = 0x100000001b3ULL;
+constexpr uint64_t kFnvOffset  = 0xcbf29ce484222325ULL;
+// a temporary file older than it is left by a crashed writer
+constexpr time_t kStaleTmpSeconds = 600;
+
+uint64_t Fnv1a(const char* data, size_t size, uint64_t hash) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+uint64_t Checksum(const std::string& data) { return Fnv1a(data.data(), data.size(), kFnvOffset); }
+
+bool MakeDirectories(const std::string& dir) {
+  std::string path;
+  std::stringstream ss(dir);
+  std::string item;
+  if (!dir.empty() && dir[0] == '/') path = "/";
+  while (std::getline(ss, item, '/')) {
+    if (item.empty()) continue;
+    path += item + "/";
+    if (mkdir(path.c_str(), 0755) == -1 && errno != EEXIST) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+DiskObjectCache* DiskObjectCache::Global() {
+  static std::unique_ptr<DiskObjectCache> cache = []() -> std::unique_ptr<DiskObjectCache> {
+    if (FLAGS_cinn_jit_cache_dir.empty()) {
+      return nullptr;
+    }
+    uint64_t max_bytes = static_cast<uint64_t>(std::max(FLAGS_cinn_jit_cache_max_mb, 0)) << 20;
+    return std::make_unique<DiskObjectCache>(FLAGS_cinn_jit_cache_dir, max_bytes);
+  }();
+  return cache.get();
+}
+
+DiskObjectCache::DiskObjectCache(const std::string& dir, uint64_t max_bytes) : dir_(dir), max_bytes_(max_bytes) {
+  while (dir_.size() > 1 && dir_.back() == '/') dir_.pop_back();
+  if (!MakeDirectories(dir_)) {
+    LOG(WARNING) << "Failed to create the JIT cache directory " << dir_ << ": " << std::strerror(errno);
+  }
+}
+
+std::string DiskObjectCache::HashKey(const std::vector<std::string>& parts) {
+  // each part is prefixed by its length so that different splits of a same string never collide
+  llvm::SHA256 hasher;
+  for (auto& part : parts) {
+    uint64_t size = part.size();
+    hasher.update(llvm::StringRef(reinterpret_cast<const char*>(&size), sizeof(size)));
+    hasher.update(llvm::StringRef(part));
+  }
+  auto digest = hasher.final();
+  return llvm::toHex(digest, /*LowerCase=*/true);
+}
+
+std::string DiskObjectCache::ObjectPath(const std::string& key) const { return dir_ + "/" + key + kObjectSuffix; }
+
+bool DiskObjectCache::Load(const std::string& key, std::string* object) {
+  auto path = ObjectPath(key);
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+  // layout: magic | key | payload size | payload checksum | payload, the key stored in the entry must equal the
+  // requested one, so that an entry written for another key, such as by another build, is never linked
+  const size_t header_len = kMagicLen + key.size() + 2 * sizeof(uint64_t);
+  uint64_t size = 0, checksum = 0;
+  bool valid = content.size() >= header_len && content.compare(0, kMagicLen, kMagic) == 0 &&
+               content.compare(kMagicLen, key.size(), key) == 0;
+  if (valid) {
+    std::memcpy(&size, content.data() + kMagicLen + key.size(), sizeof(size));
+    std::memcpy(&checksum, content.data() + kMagicLen + key.size() + sizeof(size), sizeof(checksum));
+    valid = content.size() - header_len == size;
+  }
+  if (valid) {
+    object->assign(content, header_len, std::string::npos);
+    valid = Checksum(*object) == checksum;
+  }
+  if (!valid) {
+    LOG(WARNING) << "Remove the broken or mismatched JIT cache file " << path;
+    std::remove(path.c_str());
+    object->clear();
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // refresh the modification time, which orders the objects to evict
+  utime(path.c_str(), nullptr);
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  VLOG(3) << "Load the JIT object " << key << " of " << object->size() << " bytes from " << dir_;
+  return true;
+}
+
+void DiskObjectCache::Store(const std::string& key, const std::string& object) {
+  if (object.size() + kMagicLen + key.size() + 2 * sizeof(uint64_t) > max_bytes_) {
+    VLOG(3) << "Skip caching the JIT object " << key << " larger than the cache limit";
+    return;
+  }
+  auto path = ObjectPath(key);
+  // a temporary file unique in the host, renaming it is atomic so that the other
+  // processes either see the complete object or nothing
+  std::ostringstream tmp_path;
+  tmp_path << path << kTmpInfix << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+  {
+    std::ofstream ofs(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      LOG(WARNING) << "Failed to write the JIT cache file " << tmp_path.str();
+      return;
+    }
+    uint64_t size = object.size(), checksum = Checksum(object);
+    ofs.write(kMagic, kMagicLen);
+    ofs.write(key.data(), key.size());
+    ofs.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    ofs.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    ofs.write(object.data(), object.size());
+    if (!ofs.good()) {
+      ofs.close();
+      std::remove(tmp_path.str().c_str());
+      LOG(WARNING) << "Failed to write the JIT cache file " << tmp_path.str();
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+    LOG(WARNING) << "Failed to rename the JIT cache file to " << path << ": " << std::strerror(errno);
+    return;
+  }
+  stores_.fetch_add(1, std::memory_order_relaxed);
+  VLOG(3) << "Store the JIT object " << key << " of " << object.size() << " bytes into " << dir_;
+  EvictIfNeeded();
+}
+
+void DiskObjectCache::EvictIfNeeded() {
+  // the lock serializes the evictions of all processes sharing the directory
+  auto lock_path = dir_ + "/.lock";
+  int lock_fd    = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (lock_fd < 0) {
+    LOG(WARNING) << "Failed to open the JIT cache lock " << lock_path << ": " << std::strerror(errno);
+    return;
+  }
+  flock(lock_fd, LOCK_EX);
+
+  struct Entry {
+    std::string path;
+    uint64_t size;
+    struct timespec mtime;
+  };
+  std::vector<Entry> entries;
+  uint64_t total_bytes = 0;
+  time_t now           = time(nullptr);
+  if (DIR* dir = opendir(dir_.c_str())) {
+    while (struct dirent* ent = readdir(dir)) {
+      std::string name = ent->d_name;
+      bool is_tmp      = name.find(kTmpInfix) != std::string::npos;
+      if (!is_tmp && !EndsWith(name, kObjectSuffix)) continue;
+      std::string path = dir_ + "/" + name;
+      struct stat st;
+      if (stat(path.c_str(), &st) != 0) continue;
+      if (is_tmp) {
+        // the writers rename their temporary files in a moment, so an old one is left by a crashed writer
+        if (now - st.st_mtim.tv_sec > kStaleTmpSeconds && std::remove(path.c_str()) == 0) {
+          VLOG(3) << "Remove the stale JIT cache file " << path;
+        }
+        continue;
+      }
+      entries.push_back({path, static_cast<uint64_t>(st.st_size), st.st_mtim});
+      total_bytes += st.st_size;
+    }
+    closedir(dir);
+  }
+
+  if (total_bytes > max_bytes_) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+      return a.mtime.tv_sec != b.mtime.tv_sec ? a.mtime.tv_sec < b.mtime.tv_sec : a.mtime.tv_nsec < b.mtime.tv_nsec;
+    });
+    for (auto& entry : entries) {
+      if (total_bytes <= max_bytes_) break;
+      if (std::remove(entry.path.c_str()) == 0) {
+        total_bytes -= entry.size;
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+        VLOG(3) << "Evict the JIT cache file " << entry.path;
+      }
+    }
+  }
+
+  flock(lock_fd, LOCK_UN);
+  close(lock_fd);
+}
+
+DiskObjectCache::Stats DiskObjectCache::GetStats() const {
+  Stats stats;
+  stats.hits      = hits_.load(std::memory_order_relaxed);
+  stats.misses    = misses_.load(std::memory_order_relaxed);
+  stats.stores    = stores_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+std::string DiskObjectCache::DebugString() const {
+  auto stats = GetStats();
+  std::ostringstream os;
+  os << "DiskObjectCache(" << dir_ << "): hits " << stats.hits << ", misses " << stats.misses << ", stores "
+     << stats.stores << ", evictions " << stats.evictions;
+  return os.str();
+}
+
+}  // namespace cinn::backends
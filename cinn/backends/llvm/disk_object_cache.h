@@ -0,0 +1,77 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cinn::backends {
+
+/**
+ * DiskObjectCache keeps the object code emitted by the LLVM backend in a directory, which is addressed by a SHA-256
+ * of the module IR, the host target and the LLVM options, so that a restarted process or another model containing
+ * the same kernels can link the objects without optimizing and emitting them again. Each file records its key, and a
+ * file holding another key is never loaded.
+ *
+ * An object is written to a temporary file and renamed to its final path, so that readers never see a partial one,
+ * and several processes on one host can share a directory. Once the total size exceeds the limit, the least recently
+ * used objects are evicted under an exclusive file lock, and a hit refreshes the modification time of its file. The
+ * temporary files left by crashed writers are removed by the same scan.
+ */
+class DiskObjectCache {
+ public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t stores{0};
+    uint64_t evictions{0};
+  };
+
+  //! The cache in FLAGS_cinn_jit_cache_dir, it is nullptr if the flag is empty.
+  static DiskObjectCache* Global();
+
+  DiskObjectCache(const std::string& dir, uint64_t max_bytes);
+
+  //! Get the hexadecimal SHA-256 of \p parts, which does not change across processes.
+  static std::string HashKey(const std::vector<std::string>& parts);
+
+  //! Load the object of \p key, return false if it is absent or broken.
+  bool Load(const std::string& key, std::string* object);
+
+  void Store(const std::string& key, const std::string& object);
+
+  Stats GetStats() const;
+  std::string DebugString() const;
+
+  const std::string& dir() const { return dir_; }
+
+ private:
+  std::string ObjectPath(const std::string& key) const;
+
+  // remove the least recently used objects until the total size is within max_bytes_
+  void EvictIfNeeded();
+
+  std::string dir_;
+  uint64_t max_bytes_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> stores_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace cinn::backends
@@ -0,0 +1,177 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/disk_object_cache.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cinn::backends {
+
+std::string MakeTempDir() {
+  char dir[] = "/tmp/cinn_jit_cache_XXXXXX";
+  EXPECT_NE(mkdtemp(dir), nullptr);
+  return dir;
+}
+
+bool FileExists(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+TEST(DiskObjectCache, HashKey) {
+  auto key = DiskObjectCache::HashKey({"module", "x86_64", "avx2"});
+  ASSERT_EQ(key.size(), 64UL);
+  ASSERT_EQ(key, DiskObjectCache::HashKey({"module", "x86_64", "avx2"}));
+  ASSERT_NE(key, DiskObjectCache::HashKey({"module", "x86_64", "avx512f"}));
+  ASSERT_NE(DiskObjectCache::HashKey({"ab", "c"}), DiskObjectCache::HashKey({"a", "bc"}));
+}
+
+TEST(DiskObjectCache, StoreAndLoad) {
+  DiskObjectCache cache(MakeTempDir() + "/nested/", 1 << 20);
+  auto key = DiskObjectCache::HashKey({"fn_add"});
+  std::string object;
+  ASSERT_FALSE(cache.Load(key, &object));
+
+  std::string code("\x7f"
+                   "ELF\0object",
+                   11);
+  cache.Store(key, code);
+  ASSERT_TRUE(cache.Load(key, &object));
+  ASSERT_EQ(object, code);
+
+  // another cache on the same directory, such as in a restarted process
+  DiskObjectCache other(cache.dir(), 1 << 20);
+  ASSERT_TRUE(other.Load(key, &object));
+  ASSERT_EQ(object, code);
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.hits, 1UL);
+  ASSERT_EQ(stats.misses, 1UL);
+  ASSERT_EQ(stats.stores, 1UL);
+  ASSERT_EQ(stats.evictions, 0UL);
+}
+
+TEST(DiskObjectCache, BrokenFile) {
+  DiskObjectCache cache(MakeTempDir(), 1 << 20);
+  auto key = DiskObjectCache::HashKey({"fn_broken"});
+  cache.Store(key, std::string(64, 'x'));
+  auto path = cache.dir() + "/" + key + ".o";
+  {
+    std::ofstream ofs(path, std::ios::binary | std::ios::in | std::ios::out);
+    ofs.seekp(120);
+    ofs.put('y');
+  }
+  std::string object;
+  ASSERT_FALSE(cache.Load(key, &object));
+  ASSERT_FALSE(FileExists(path));
+  ASSERT_EQ(cache.GetStats().misses, 1UL);
+}
+
+TEST(DiskObjectCache, KeyMismatch) {
+  DiskObjectCache cache(MakeTempDir(), 1 << 20);
+  auto key   = DiskObjectCache::HashKey({"fn_stored"});
+  auto other = DiskObjectCache::HashKey({"fn_other"});
+  cache.Store(key, std::string(64, 'x'));
+  // an intact entry found under another key, such as written by another build, is not linked
+  auto other_path = cache.dir() + "/" + other + ".o";
+  ASSERT_EQ(std::rename((cache.dir() + "/" + key + ".o").c_str(), other_path.c_str()), 0);
+  std::string object;
+  ASSERT_FALSE(cache.Load(other, &object));
+  ASSERT_FALSE(FileExists(other_path));
+}
+
+TEST(DiskObjectCache, RemoveStaleTmpFiles) {
+  DiskObjectCache cache(MakeTempDir(), 1 << 20);
+  auto make_tmp = [&](const std::string& name, time_t seconds) {
+    auto path = cache.dir() + "/" + name;
+    std::ofstream(path) << "partial";
+    if (seconds) {
+      struct utimbuf times {
+        seconds, seconds
+      };
+      utime(path.c_str(), &times);
+    }
+    return path;
+  };
+  auto stale  = make_tmp(DiskObjectCache::HashKey({"fn_crashed"}) + ".o.tmp.123.456", 1000);
+  auto recent = make_tmp(DiskObjectCache::HashKey({"fn_writing"}) + ".o.tmp.123.789", 0);
+
+  // the temporary file of a crashed writer is removed when storing, while the one being written is kept
+  cache.Store(DiskObjectCache::HashKey({"fn_new"}), std::string(64, 'x'));
+  ASSERT_FALSE(FileExists(stale));
+  ASSERT_TRUE(FileExists(recent));
+}
+
+TEST(DiskObjectCache, EvictLeastRecentlyUsed) {
+  // each file holds a 88 bytes header and a 1000 bytes object, so only two of them fit
+  DiskObjectCache cache(MakeTempDir(), 2300);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 3; ++i) {
+    keys.push_back(DiskObjectCache::HashKey({"fn_" + std::to_string(i)}));
+  }
+  auto set_mtime = [&](const std::string& key, time_t seconds) {
+    struct utimbuf times {
+      seconds, seconds
+    };
+    utime((cache.dir() + "/" + key + ".o").c_str(), &times);
+  };
+
+  cache.Store(keys[0], std::string(1000, 'a'));
+  set_mtime(keys[0], 1000);
+  cache.Store(keys[1], std::string(1000, 'b'));
+  set_mtime(keys[1], 2000);
+
+  // using the first object makes the second one the least recently used
+  std::string object;
+  ASSERT_TRUE(cache.Load(keys[0], &object));
+  cache.Store(keys[2], std::string(1000, 'c'));
+
+  ASSERT_EQ(cache.GetStats().evictions, 1UL);
+  ASSERT_TRUE(cache.Load(keys[0], &object));
+  ASSERT_FALSE(cache.Load(keys[1], &object));
+  ASSERT_TRUE(cache.Load(keys[2], &object));
+}
+
+TEST(DiskObjectCache, ConcurrentStore) {
+  DiskObjectCache cache(MakeTempDir(), 1 << 20);
+  auto key = DiskObjectCache::HashKey({"fn_shared"});
+  std::string code(4096, 'z');
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 16; ++j) {
+        cache.Store(key, code);
+        std::string object;
+        if (cache.Load(key, &object)) {
+          ASSERT_EQ(object, code);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  std::string object;
+  ASSERT_TRUE(cache.Load(key, &object));
+  ASSERT_EQ(object, code);
+}
+
+}  // namespace cinn::backends
@@ -58,6 +58,7 @@
 #include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
 #include "cinn/backends/llvm/codegen_llvm.h"
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/disk_object_cache.h"
 #include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
@@ -116,7 +117,8 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   llvm::InitializeNativeTargetAsmPrinter();
   InitializeLLVMPasses();
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
+  auto engine              = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
+  engine->concurrent_link_ = config.concurrent_link;
 
   auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
@@ -160,25 +162,82 @@ void ExecutionEngine::Link(const ir::Module &module) {
   auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
   auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
   auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
+  // the runtime definitions are copied into every module, which conflict in one engine unless internal
+  std::vector<llvm::GlobalValue *> runtime_definitions;
+  if (concurrent_link_) {
+    for (auto &f : *m) {
+      if (!f.isDeclaration()) runtime_definitions.push_back(&f);
+    }
+    for (auto &g : m->globals()) {
+      if (!g.isDeclaration()) runtime_definitions.push_back(&g);
+    }
+  }
   VLOG(3) << "ir_emitter->Compile(module) Begin";
   ir_emitter->Compile(module);
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
+  for (auto *value : runtime_definitions) {
+    value->setLinkage(llvm::GlobalValue::InternalLinkage);
+    if (auto *object = llvm::dyn_cast<llvm::GlobalObject>(value)) {
+      object->setComdat(nullptr);
+    }
+  }
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
   auto machine =
       std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+  constexpr int opt_level = 3;
+
+  // the object only depends on the emitted IR, the host target and the optimization options,
+  // so that an object cached by the same kernel is linked without optimizing and emitting again
+  auto *disk_cache = DiskObjectCache::Global();
+  std::string cache_key;
+  if (disk_cache) {
+    std::string module_ir;
+    llvm::raw_string_ostream os(module_ir);
+    m->print(os, nullptr);
+    os.flush();
+    cache_key = DiskObjectCache::HashKey({module_ir,
+                                          machine->getTargetTriple().str(),
+                                          machine->getTargetCPU().str(),
+                                          machine->getTargetFeatureString().str(),
+                                          std::to_string(opt_level),
+                                          LLVM_VERSION_STRING});
+    std::string object;
+    if (disk_cache->Load(cache_key, &object)) {
+      if (concurrent_link_) {
+        llvm::cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(object, "cinn_object")));
+      } else {
+        AddObject(object);
+      }
+      VLOG(3) << "Link the cached object " << cache_key << ", " << disk_cache->DebugString();
+      return;
+    }
+  }
+
+  LLVMModuleOptimizer optimize(machine.get(), opt_level, {}, true);
   optimize(m.get());
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
     VLOG(5) << "function: " << DumpToString(f);
   }
 
-  llvm::raw_svector_ostream rawstream(buffer_);
+  llvm::SmallString<0> object;
+  llvm::raw_svector_ostream rawstream(object);
   llvm::legacy::PassManager pass_manager;
   machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
   pass_manager.run(*m);
+  if (disk_cache) {
+    disk_cache->Store(cache_key, std::string(object.begin(), object.end()));
+  }
 
+  if (concurrent_link_) {
+    // the object is emitted already, linking it avoids compiling the module again in the JIT
+    llvm::cantFail(
+        jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(object.data(), object.size()),
+                                                                 m->getModuleIdentifier())));
+    return;
+  }
+  buffer_.append(object.begin(), object.end());
   CHECK(AddModule(std::move(m), std::move(ctx)));
 
   decltype(auto) es = jit_->getExecutionSession();
@@ -215,6 +274,13 @@ void ExecutionEngine::ExportObject(const std::string &path) {
   fclose(of);
 }
 
+void ExecutionEngine::AddObject(const std::string &object_code) {
+  auto object = llvm::MemoryBuffer::getMemBufferCopy(object_code, "cinn_object");
+  llvm::cantFail(jit_->addObjectFile(std::move(object)));
+  // keep the object so that it can be exported again, after the objects linked before like Link does
+  buffer_.append(object_code.begin(), object_code.end());
+}
+
 void *ExecutionEngine::Lookup(absl::string_view name) {
   std::lock_guard<std::mutex> lock(mu_);
   if (auto symbol = jit_->lookup(AsStringRef(name))) {
@@ -226,13 +292,20 @@ void *ExecutionEngine::Lookup(absl::string_view name) {
 }
 
 void ExecutionEngine::RegisterRuntimeSymbols() {
-  const auto &registry = GlobalSymbolRegistry::Global();
-  auto *session        = &jit_->getExecutionSession();
-  for (const auto &sym : registry.All()) {
-    llvm::cantFail(jit_->define(llvm::orc::absoluteSymbols(
-        {{session->intern(sym.first), {llvm::pointerToJITTargetAddress(sym.second), llvm::JITSymbolFlags::None}}})));
-  }
-  for (const auto &sym : module_symbols_.All()) {
+  DefineSymbols(GlobalSymbolRegistry::Global());
+  DefineSymbols(module_symbols_);
+}
+
+void ExecutionEngine::RegisterSymbols(RuntimeSymbols &&symbols) {
+  auto holder = std::make_unique<RuntimeSymbols>(std::move(symbols));
+  DefineSymbols(*holder);
+  std::lock_guard<std::mutex> lock(mu_);
+  extra_symbols_.push_back(std::move(holder));
+}
+
+void ExecutionEngine::DefineSymbols(const RuntimeSymbols &symbols) {
+  auto *session = &jit_->getExecutionSession();
+  for (const auto &sym : symbols.All()) {
     llvm::cantFail(jit_->define(llvm::orc::absoluteSymbols(
         {{session->intern(sym.first), {llvm::pointerToJITTargetAddress(sym.second), llvm::JITSymbolFlags::None}}})));
   }
@@ -62,6 +62,9 @@ class NaiveObjectCache : public llvm::ObjectCache {
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
+  // link the emitted objects rather than the IR modules, and keep the runtime functions
+  // of each module internal, so that several threads can Link modules into one engine
+  bool concurrent_link{false};
   // TODO(fc500110)
   // int num_compile_threads{1};
   // bool enable_fast_math;
@@ -80,8 +83,17 @@ class ExecutionEngine {
 
   void ExportObject(const std::string &path);
 
+  //! Get the object code emitted by all the Link and AddObject calls in order, which can be linked by AddObject later.
+  std::string GetObjectCode() const { return std::string(buffer_.begin(), buffer_.end()); }
+
+  //! Link a relocatable object without compiling any IR.
+  void AddObject(const std::string &object_code);
+
   bool AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context);
 
+  //! Define more external symbols after the engine is created, such as the kernels of a device module.
+  void RegisterSymbols(RuntimeSymbols &&symbols);
+
  protected:
   explicit ExecutionEngine(bool enable_object_cache, RuntimeSymbols &&module_symbols)
       : cache_(std::make_unique<NaiveObjectCache>()), module_symbols_(std::move(module_symbols)) {}
@@ -94,11 +106,16 @@ class ExecutionEngine {
   friend std::unique_ptr<ExecutionEngine> std::make_unique<ExecutionEngine>(bool &&, cinn::backends::RuntimeSymbols &&);
 
  private:
+  void DefineSymbols(const RuntimeSymbols &symbols);
+
   mutable std::mutex mu_;
   llvm::SmallString<0> buffer_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
   RuntimeSymbols module_symbols_;
+  // the symbols registered after created, which should be alive as long as the engine
+  std::vector<std::unique_ptr<RuntimeSymbols>> extra_symbols_;
+  bool concurrent_link_{false};
 };
 
 }  // namespace cinn::backends
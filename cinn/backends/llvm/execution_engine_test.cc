@@ -32,6 +32,7 @@
 #include <iomanip>
 #include <memory>
 #include <random>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -91,7 +92,7 @@ auto CreateTestBuffer() {
   return std::make_tuple(A, B, C);
 }
 
-auto CreateTestCinnModule() {
+auto CreateTestCinnModule(const std::string &fn_name = "elementwise_add") {
   ir::Expr M(kM);
   ir::Expr N(kN);
   lang::Placeholder<float> A("A", {M, N});
@@ -109,7 +110,7 @@ auto CreateTestCinnModule() {
   ir::Module::Builder builder("module1", target);
 
   auto stages = CreateStages({C});
-  auto funcs  = lang::Lower("elementwise_add", stages, {A, B, C});
+  auto funcs  = lang::Lower(fn_name, stages, {A, B, C});
 
   // auto func = optim::Optimize(funcs);
 
@@ -325,5 +326,42 @@ TEST(ExecutionEngine, call_extern) {
   }
 }
 
+TEST(ExecutionEngine, concurrent_link) {
+  ExecutionOptions options;
+  options.concurrent_link = true;
+  auto engine             = ExecutionEngine::Create(options);
+
+  // every module carries the same runtime definitions
+  constexpr int kNumModules = 4;
+  std::vector<ir::Module> modules;
+  for (int i = 0; i < kNumModules; ++i) {
+    modules.push_back(CreateTestCinnModule("elementwise_add_" + std::to_string(i)));
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumModules; ++i) {
+    threads.emplace_back([&, i]() { engine->Link(modules[i]); });
+  }
+  for (auto &t : threads) t.join();
+
+  auto _a_b_c_ = CreateTestBuffer();  // NOLINT
+  auto &a      = std::get<0>(_a_b_c_);
+  auto &b      = std::get<1>(_a_b_c_);
+  auto &c      = std::get<2>(_a_b_c_);
+  cinn_pod_value_t a_arg(a), b_arg(b), c_arg(c);
+  cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+  float *ad                = reinterpret_cast<float *>(a->memory);
+  float *bd                = reinterpret_cast<float *>(b->memory);
+  float *cd                = reinterpret_cast<float *>(c->memory);
+  for (int i = 0; i < kNumModules; ++i) {
+    auto fn_addr = engine->Lookup("elementwise_add_" + std::to_string(i));
+    ASSERT_NE(fn_addr, nullptr);
+    std::fill(cd, cd + c->num_elements(), 0.f);
+    reinterpret_cast<void (*)(void *, int32_t)>(fn_addr)(args, 3);
+    for (int j = 0; j < c->num_elements(); j++) {
+      ASSERT_EQ(ad[j] + bd[j], cd[j]);
+    }
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
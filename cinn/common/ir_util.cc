@@ -15,6 +15,7 @@
 #include "cinn/common/ir_util.h"
 
 #include <algorithm>
+#include <limits>
 #include <unordered_set>
 
 #include "cinn/common/cas.h"
@@ -130,10 +131,42 @@ Expr RampRelatedMul(Expr a, Expr b) {
   }
 }
 
+// Whether the offset of a buffer should be computed in 64-bit, it is only needed when the buffer
+// has more elements than the range of int32, so small buffers keep the fast 32-bit arithmetic.
+bool NeedInt64Offset(const std::vector<Expr> &shape, const std::vector<Expr> &indices) {
+  int64_t extent = 1;
+  for (auto &dim : shape) {
+    if (!dim.is_constant()) return false;
+    extent *= dim.as_int32();
+  }
+  if (extent <= std::numeric_limits<int32_t>::max()) return false;
+  for (auto &indice : indices) {
+    if (indice.type().is_vector()) {
+      VLOG(3) << "The buffer has " << extent << " elements, but its vectorized offset is still computed in int32";
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 Expr IndiceToAbsOffset(const std::vector<Expr> &shape, const std::vector<Expr> &indices) {
   CHECK_GE(shape.size(), indices.size());
+  if (NeedInt64Offset(shape, indices)) {
+    // build the offset without AutoSimplify, which folds constants in int32
+    Expr res;
+    for (int i = 0; i < shape.size(); i++) {
+      CHECK_EQ(shape[i].type(), Int(32));
+      Expr indice_prod = indices[i].type() == Int(64) ? indices[i] : ir::Cast::Make(Int(64), indices[i]);
+      for (int j = i + 1; j < shape.size(); j++) {
+        indice_prod = indice_prod * Expr(static_cast<int64_t>(shape[j].as_int32()));
+      }
+      res = res.defined() ? res + indice_prod : indice_prod;
+    }
+    return res;
+  }
+
   Expr res;
   for (int i = 0; i < shape.size(); i++) {
     CHECK_EQ(shape[i].type(), Int(32));
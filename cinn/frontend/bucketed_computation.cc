@@ -0,0 +1,280 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/bucketed_computation.h"
+
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace frontend {
+
+using hlir::framework::shape_t;
+
+struct BucketedComputation::Entry {
+  std::shared_future<std::shared_ptr<CinnComputation>> computation;
+  std::list<std::string>::iterator lru_it;
+
+  // the following members are guarded by run_mtx
+  std::mutex run_mtx;
+  // the inputs padded up to the bucket and their actual shapes in the last run
+  std::vector<std::vector<char>> padded_inputs;
+  std::vector<shape_t> padded_shapes;
+  // the staging memory of an output to be sliced
+  std::vector<char> output_buffer;
+};
+
+namespace {
+
+std::vector<size_t> GetByteStrides(const shape_t& shape, size_t elem_bytes) {
+  std::vector<size_t> strides(shape.size());
+  size_t stride = elem_bytes;
+  for (int axis = static_cast<int>(shape.size()) - 1; axis >= 0; --axis) {
+    strides[axis] = stride;
+    stride *= shape[axis];
+  }
+  return strides;
+}
+
+void CopyRegionImpl(const char* src,
+                    const std::vector<size_t>& src_strides,
+                    char* dst,
+                    const std::vector<size_t>& dst_strides,
+                    const shape_t& region,
+                    size_t elem_bytes,
+                    int axis) {
+  if (axis + 1 == region.size()) {
+    std::memcpy(dst, src, region[axis] * elem_bytes);
+    return;
+  }
+  for (int i = 0; i < region[axis]; ++i) {
+    CopyRegionImpl(src + i * src_strides[axis],
+                   src_strides,
+                   dst + i * dst_strides[axis],
+                   dst_strides,
+                   region,
+                   elem_bytes,
+                   axis + 1);
+  }
+}
+
+// copy the leading `region` of a row-major array of `src_shape` into the leading corner of one of `dst_shape`
+void CopyRegion(const void* src,
+                const shape_t& src_shape,
+                void* dst,
+                const shape_t& dst_shape,
+                const shape_t& region,
+                size_t elem_bytes) {
+  CHECK_EQ(src_shape.size(), region.size());
+  CHECK_EQ(dst_shape.size(), region.size());
+  if (region.empty()) {
+    std::memcpy(dst, src, elem_bytes);
+    return;
+  }
+  CopyRegionImpl(static_cast<const char*>(src),
+                 GetByteStrides(src_shape, elem_bytes),
+                 static_cast<char*>(dst),
+                 GetByteStrides(dst_shape, elem_bytes),
+                 region,
+                 elem_bytes,
+                 0);
+}
+
+size_t GetNumBytes(const shape_t& shape, size_t elem_bytes) {
+  size_t bytes = elem_bytes;
+  for (int extent : shape) {
+    bytes *= extent;
+  }
+  return bytes;
+}
+
+}  // namespace
+
+BucketedComputation::BucketedComputation(const std::vector<std::string>& input_names,
+                                         CompileFunc compile_func,
+                                         Options options)
+    : input_names_(input_names), compile_func_(std::move(compile_func)), options_(std::move(options)) {
+  CHECK(!input_names_.empty()) << "BucketedComputation requires at least one input";
+  CHECK_GT(options_.capacity, 0) << "The capacity of BucketedComputation should be positive";
+}
+
+std::unique_ptr<BucketedComputation> BucketedComputation::FromPaddleModel(
+    const Target& target,
+    const std::string& model_path,
+    const std::vector<std::string>& input_names,
+    bool params_combined,
+    const Options& options,
+    const CinnComputation::CompileOptions& compile_options) {
+  auto compile_func = [=](const std::vector<shape_t>& input_shapes) {
+    return CinnComputation::CompilePaddleModel(
+        target, model_path, input_names, input_shapes, params_combined, compile_options);
+  };
+  return std::make_unique<BucketedComputation>(input_names, std::move(compile_func), options);
+}
+
+int BucketedComputation::GetBucketExtent(int extent) {
+  CHECK_GT(extent, 0) << "The extent of a dynamic axis should be positive";
+  int bucket = 1;
+  while (bucket < extent) {
+    bucket <<= 1;
+  }
+  return bucket;
+}
+
+std::shared_ptr<BucketedComputation::Entry> BucketedComputation::GetOrCompile(
+    const std::vector<shape_t>& bucket_shapes) {
+  std::stringstream ss;
+  for (auto& shape : bucket_shapes) {
+    ss << utils::Join(shape, "x") << ";";
+  }
+  auto key = ss.str();
+
+  std::shared_ptr<Entry> entry;
+  std::promise<std::shared_ptr<CinnComputation>> promise;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++stats_.hits;
+      entry = it->second;
+      lru_keys_.splice(lru_keys_.begin(), lru_keys_, entry->lru_it);
+      return entry;
+    }
+    ++stats_.misses;
+    entry              = std::make_shared<Entry>();
+    entry->computation = promise.get_future().share();
+    entry->lru_it      = lru_keys_.insert(lru_keys_.begin(), key);
+    entries_.emplace(key, entry);
+    // the evicted entries stay alive until the runs holding them finish
+    while (lru_keys_.size() > options_.capacity) {
+      entries_.erase(lru_keys_.back());
+      lru_keys_.pop_back();
+      ++stats_.evictions;
+    }
+  }
+
+  // compile out of the lock, so the hits of other buckets are not blocked
+  std::lock_guard<std::mutex> compile_lock(compile_mtx_);
+  VLOG(3) << "Compile the computation for the bucket " << key;
+  try {
+    promise.set_value(compile_func_(bucket_shapes));
+  } catch (...) {
+    // the failed entry is dropped, so the next run of the bucket compiles it again, and the waiting runs rethrow
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      auto it = entries_.find(key);
+      if (it != entries_.end() && it->second == entry) {
+        lru_keys_.erase(entry->lru_it);
+        entries_.erase(it);
+      }
+    }
+    promise.set_exception(std::current_exception());
+  }
+  return entry;
+}
+
+std::vector<BucketedComputation::Fetch> BucketedComputation::Run(const std::vector<Feed>& feeds) {
+  CHECK_EQ(feeds.size(), input_names_.size()) << "The number of feeds should be equal to the number of inputs";
+  std::vector<shape_t> bucket_shapes;
+  for (auto& feed : feeds) {
+    auto shape = feed.shape;
+    for (int axis : options_.dynamic_axes) {
+      if (axis < shape.size()) {
+        shape[axis] = GetBucketExtent(shape[axis]);
+      }
+    }
+    bucket_shapes.emplace_back(std::move(shape));
+  }
+  auto entry       = GetOrCompile(bucket_shapes);
+  auto computation = entry->computation.get();
+
+  std::lock_guard<std::mutex> lock(entry->run_mtx);
+  entry->padded_inputs.resize(feeds.size());
+  entry->padded_shapes.resize(feeds.size());
+  for (int i = 0; i < feeds.size(); ++i) {
+    auto tensor       = computation->GetTensor(input_names_[i]);
+    size_t elem_bytes = tensor->type().bytes();
+    CHECK(tensor->shape().data() == bucket_shapes[i])
+        << "The shape of input " << input_names_[i] << " is [" << utils::Join(tensor->shape().data(), ", ")
+        << "] rather than the bucket [" << utils::Join(bucket_shapes[i], ", ") << "]";
+    size_t bytes = GetNumBytes(bucket_shapes[i], elem_bytes);
+    if (feeds[i].shape == bucket_shapes[i]) {
+      computation->SetTensorData(tensor, const_cast<void*>(feeds[i].data), bytes);
+      continue;
+    }
+    // the padding is zeroed only when the actual shape changes, as the region of data is overwritten by each run
+    auto& padded = entry->padded_inputs[i];
+    if (padded.size() != bytes || entry->padded_shapes[i] != feeds[i].shape) {
+      padded.assign(bytes, 0);
+      entry->padded_shapes[i] = feeds[i].shape;
+    }
+    CopyRegion(feeds[i].data, feeds[i].shape, padded.data(), bucket_shapes[i], feeds[i].shape, elem_bytes);
+    computation->SetTensorData(tensor, padded.data(), bytes);
+  }
+
+  computation->Execute();
+
+  const auto& actual_shape = feeds.front().shape;
+  const auto& bucket_shape = bucket_shapes.front();
+  auto output_tensors      = computation->GetOutputTensors();
+  CHECK(options_.output_dynamic_axes.empty() || options_.output_dynamic_axes.size() == output_tensors.size())
+      << "The output_dynamic_axes should be given for all the " << output_tensors.size() << " outputs";
+  std::vector<Fetch> fetches;
+  for (int i = 0; i < output_tensors.size(); ++i) {
+    auto& tensor = output_tensors[i];
+    Fetch fetch;
+    fetch.type        = tensor->type();
+    auto output_shape = tensor->shape().data();
+    fetch.shape       = output_shape;
+    for (int k = 0; k < options_.dynamic_axes.size(); ++k) {
+      int input_axis = options_.dynamic_axes[k];
+      if (input_axis >= actual_shape.size()) {
+        continue;
+      }
+      int output_axis = options_.output_dynamic_axes.empty() ? input_axis : options_.output_dynamic_axes[i][k];
+      if (output_axis < 0 || (options_.output_dynamic_axes.empty() && output_axis >= output_shape.size())) {
+        continue;
+      }
+      CHECK_LT(output_axis, output_shape.size()) << "The dynamic axis " << output_axis << " of output " << i
+                                                 << " is out of range [" << utils::Join(output_shape, ", ") << "]";
+      CHECK_EQ(output_shape[output_axis], bucket_shape[input_axis])
+          << "The axis " << output_axis << " of output " << i << " with shape [" << utils::Join(output_shape, ", ")
+          << "] is not the bucket of the dynamic axis " << input_axis << ", please set output_dynamic_axes";
+      fetch.shape[output_axis] = actual_shape[input_axis];
+    }
+    size_t elem_bytes = fetch.type.bytes();
+    size_t bytes      = GetNumBytes(output_shape, elem_bytes);
+    fetch.data.resize(GetNumBytes(fetch.shape, elem_bytes));
+    if (fetch.shape == output_shape) {
+      computation->GetTensorData(tensor, fetch.data.data(), bytes);
+    } else {
+      entry->output_buffer.resize(bytes);
+      computation->GetTensorData(tensor, entry->output_buffer.data(), bytes);
+      CopyRegion(entry->output_buffer.data(), output_shape, fetch.data.data(), fetch.shape, fetch.shape, elem_bytes);
+    }
+    fetches.emplace_back(std::move(fetch));
+  }
+  return fetches;
+}
+
+BucketedComputation::Stats BucketedComputation::GetStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return stats_;
+}
+
+}  // namespace frontend
+}  // namespace cinn
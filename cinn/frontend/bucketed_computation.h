@@ -0,0 +1,129 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/computation.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * BucketedComputation runs a model on inputs of varying shapes, such as variable batch size or sequence length. It
+ * rounds the extents of the dynamic axes up to buckets (powers of two), keeps the CinnComputations compiled for the
+ * recent buckets in an LRU cache, pads the inputs with zeros up to the bucket and slices the outputs back.
+ *
+ * A bucket missing in the cache is compiled by the thread requesting it first, while the others requesting the same
+ * bucket wait for it and the ones hitting other buckets are not blocked. The compilations of different buckets are
+ * serialized as the compiler keeps global states, and so are the runs of one bucket.
+ * Padding is only correct for the models whose samples along the dynamic axes are computed independently.
+ */
+class BucketedComputation {
+ public:
+  //! compile a computation for the shapes of inputs in the order of input names
+  using CompileFunc = std::function<std::shared_ptr<CinnComputation>(const std::vector<hlir::framework::shape_t> &)>;
+
+  struct Options {
+    //! the axes of inputs whose extents vary between runs
+    std::vector<int> dynamic_axes = {0};
+    //! output_dynamic_axes[i][k] is the axis of the i-th output along which the k-th dynamic axis of the first input
+    //! lies, and the output is sliced to the actual extent of that input axis along it, -1 means the output does not
+    //! vary with the axis. Empty means every output has the dynamic axes at the same positions as the inputs.
+    std::vector<std::vector<int>> output_dynamic_axes;
+    //! the maximum number of computations cached, the least recently used one is evicted beyond it
+    int capacity = 8;
+  };
+
+  //! the data of an input in host memory with its actual shape
+  struct Feed {
+    const void *data;
+    hlir::framework::shape_t shape;
+  };
+
+  //! the data of an output copied to host memory with its actual shape
+  struct Fetch {
+    std::vector<char> data;
+    hlir::framework::shape_t shape;
+    common::Type type;
+  };
+
+  struct Stats {
+    int64_t hits      = 0;
+    int64_t misses    = 0;
+    int64_t evictions = 0;
+  };
+
+  BucketedComputation(const std::vector<std::string> &input_names, CompileFunc compile_func, Options options);
+
+  /**
+   * create a BucketedComputation compiling a paddle model for each bucket.
+   * @param target the target to run the program
+   * @param model_path the path of the paddle model
+   * @param input_names input variable names of paddle model
+   * @param params_combined whether params are stored combined
+   * @param options the options of buckets
+   * @param compile_options CompileOptions, config the compilation steps
+   * @return unique_ptr pointing to BucketedComputation instance
+   */
+  static std::unique_ptr<BucketedComputation> FromPaddleModel(
+      const Target &target,
+      const std::string &model_path,
+      const std::vector<std::string> &input_names,
+      bool params_combined,
+      const Options &options                                  = Options(),
+      const CinnComputation::CompileOptions &compile_options = CinnComputation::DefaultCompileOptions());
+
+  //! the bucket of an extent, which is the smallest power of two not less than it
+  static int GetBucketExtent(int extent);
+
+  /**
+   * run the computation compiled for the bucket of the inputs, it is safe to be called by multiple threads.
+   * @param feeds the inputs in the order of input names
+   * @return the outputs of the computation sliced to the actual shapes
+   */
+  std::vector<Fetch> Run(const std::vector<Feed> &feeds);
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry;
+
+  // get the cached entry of a bucket or compile it on miss
+  std::shared_ptr<Entry> GetOrCompile(const std::vector<hlir::framework::shape_t> &bucket_shapes);
+
+  std::vector<std::string> input_names_;
+  CompileFunc compile_func_;
+  Options options_;
+
+  // serialize the calls of compile_func_
+  std::mutex compile_mtx_;
+  mutable std::mutex mtx_;
+  // the keys of buckets from the most recently used to the least
+  std::list<std::string> lru_keys_;
+  absl::flat_hash_map<std::string, std::shared_ptr<Entry>> entries_;
+  Stats stats_;
+};
+
+}  // namespace frontend
+}  // namespace cinn
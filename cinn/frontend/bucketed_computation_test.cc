@@ -0,0 +1,168 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/bucketed_computation.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+constexpr int N = 16;
+
+std::shared_ptr<CinnComputation> CompileTestComputation(const std::vector<hlir::framework::shape_t>& input_shapes) {
+  NetBuilder builder("bucketed");
+  auto a = builder.CreateInput(Float(32), input_shapes[0], "A");
+  auto b = builder.CreateInput(Float(32), input_shapes[1], "B");
+  auto c = builder.Multiply(a, b);
+  auto d = builder.Add(a, c);
+  return CinnComputation::BuildAndCompile(common::DefaultHostTarget(), builder);
+}
+
+void RunAndCheck(BucketedComputation* computation, int batch) {
+  std::vector<float> hostA(batch * N), hostB(batch * N);
+  for (int i = 0; i < batch * N; i++) {
+    hostA[i] = static_cast<float>(i % 7) / 7 + batch;
+    hostB[i] = static_cast<float>(i % 5) / 5 - batch;
+  }
+  auto fetches = computation->Run({{hostA.data(), {batch, N}}, {hostB.data(), {batch, N}}});
+  ASSERT_EQ(fetches.size(), 1UL);
+  ASSERT_EQ(fetches[0].shape, hlir::framework::shape_t({batch, N}));
+  ASSERT_EQ(fetches[0].data.size(), batch * N * sizeof(float));
+  auto* hostD = reinterpret_cast<const float*>(fetches[0].data.data());
+  for (int i = 0; i < batch * N; i++) {
+    ASSERT_NEAR(hostD[i], hostA[i] + hostA[i] * hostB[i], 1e-5);
+  }
+}
+
+}  // namespace
+
+TEST(BucketedComputation, GetBucketExtent) {
+  ASSERT_EQ(BucketedComputation::GetBucketExtent(1), 1);
+  ASSERT_EQ(BucketedComputation::GetBucketExtent(3), 4);
+  ASSERT_EQ(BucketedComputation::GetBucketExtent(4), 4);
+  ASSERT_EQ(BucketedComputation::GetBucketExtent(33), 64);
+}
+
+TEST(BucketedComputation, PadAndSlice) {
+  BucketedComputation::Options options;
+  options.capacity = 2;
+  BucketedComputation computation({"A", "B"}, CompileTestComputation, options);
+
+  // 3 and 4 share the bucket of 4, and 5 compiles the bucket of 8
+  RunAndCheck(&computation, 3);
+  RunAndCheck(&computation, 4);
+  RunAndCheck(&computation, 3);
+  RunAndCheck(&computation, 5);
+  auto stats = computation.GetStats();
+  ASSERT_EQ(stats.hits, 2);
+  ASSERT_EQ(stats.misses, 2);
+  ASSERT_EQ(stats.evictions, 0);
+
+  // the buckets of 16 and 2 evict the least recently used buckets of 4 and 8 in turn
+  RunAndCheck(&computation, 9);
+  RunAndCheck(&computation, 2);
+  stats = computation.GetStats();
+  ASSERT_EQ(stats.misses, 4);
+  ASSERT_EQ(stats.evictions, 2);
+}
+
+TEST(BucketedComputation, ConcurrentRun) {
+  BucketedComputation computation({"A", "B"}, CompileTestComputation, BucketedComputation::Options());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&computation, t]() {
+      for (int batch = 1; batch <= 8; ++batch) {
+        RunAndCheck(&computation, (batch + t) % 8 + 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stats = computation.GetStats();
+  // the batches from 1 to 8 fall into 4 buckets, each compiled only once
+  ASSERT_EQ(stats.misses, 4);
+  ASSERT_EQ(stats.hits, 28);
+}
+
+TEST(BucketedComputation, OutputDynamicAxes) {
+  auto compile_func = [](const std::vector<hlir::framework::shape_t>& input_shapes) {
+    NetBuilder builder("bucketed");
+    auto a         = builder.CreateInput(Float(32), input_shapes[0], "A");
+    auto add       = builder.Add(a, a);
+    auto reduce    = builder.ReduceSum(a, {0});
+    auto transpose = builder.Transpose(a, {1, 0});
+    return CinnComputation::BuildAndCompile(
+        common::DefaultHostTarget(), builder, CinnComputation::DefaultCompileOptions(), {add, reduce, transpose});
+  };
+  BucketedComputation::Options options;
+  // the reduced output has no dynamic axis and the transposed one has it at axis 1
+  options.output_dynamic_axes = {{0}, {-1}, {1}};
+  BucketedComputation computation({"A"}, compile_func, options);
+
+  // the bucket of 9 is 16, which equals the static extent N
+  constexpr int batch = 9;
+  std::vector<float> hostA(batch * N);
+  for (int i = 0; i < batch * N; i++) {
+    hostA[i] = static_cast<float>(i % 7) / 7;
+  }
+  auto fetches = computation.Run({{hostA.data(), {batch, N}}});
+  ASSERT_EQ(fetches.size(), 3UL);
+  ASSERT_EQ(fetches[0].shape, hlir::framework::shape_t({batch, N}));
+  ASSERT_EQ(fetches[1].shape, hlir::framework::shape_t({N}));
+  ASSERT_EQ(fetches[2].shape, hlir::framework::shape_t({N, batch}));
+
+  auto* add       = reinterpret_cast<const float*>(fetches[0].data.data());
+  auto* reduce    = reinterpret_cast<const float*>(fetches[1].data.data());
+  auto* transpose = reinterpret_cast<const float*>(fetches[2].data.data());
+  for (int j = 0; j < N; j++) {
+    float sum = 0.f;
+    for (int i = 0; i < batch; i++) {
+      sum += hostA[i * N + j];
+      ASSERT_NEAR(add[i * N + j], 2 * hostA[i * N + j], 1e-5);
+      ASSERT_NEAR(transpose[j * batch + i], hostA[i * N + j], 1e-5);
+    }
+    ASSERT_NEAR(reduce[j], sum, 1e-4);
+  }
+}
+
+TEST(BucketedComputation, CompileFailure) {
+  int num_compiles  = 0;
+  auto compile_func = [&num_compiles](const std::vector<hlir::framework::shape_t>& input_shapes) {
+    if (++num_compiles == 1) {
+      throw std::runtime_error("compile failed");
+    }
+    return CompileTestComputation(input_shapes);
+  };
+  BucketedComputation computation({"A", "B"}, compile_func, BucketedComputation::Options());
+
+  std::vector<float> hostA(3 * N), hostB(3 * N);
+  ASSERT_THROW(computation.Run({{hostA.data(), {3, N}}, {hostB.data(), {3, N}}}), std::runtime_error);
+  // the failed bucket is not cached, so it is compiled again
+  RunAndCheck(&computation, 3);
+  ASSERT_EQ(num_compiles, 2);
+  ASSERT_EQ(computation.GetStats().misses, 2);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -14,6 +14,11 @@
 
 #include "cinn/frontend/computation.h"
 
+#include <gflags/gflags.h>
+
+#include <unordered_set>
+
+#include "cinn/frontend/constant_folding.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/program_pass.h"
 #include "cinn/hlir/framework/graph.h"
@@ -21,6 +26,8 @@
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
 
+DECLARE_bool(cinn_fold_constant_subgraphs);
+
 namespace cinn {
 namespace frontend {
 
@@ -38,6 +45,8 @@ struct ComputationContext {
   std::vector<hlir::framework::Tensor> outputs;
   std::unordered_map<std::string, Variable> varmap;
   std::unordered_map<std::string, std::string> varmap_paddle2program;
+  // the buffers whose memory is bound by the user
+  std::unordered_set<hlir::framework::Buffer *> bound_buffers;
 };
 
 std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
@@ -53,6 +62,13 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   if (ctx->compile_options.use_decomposer) {
     ProgramPass::Apply(&program, {}, target, {"Decomposer"});
   }
+  if (FLAGS_cinn_fold_constant_subgraphs && scope) {
+    std::unordered_set<std::string> fetch_var_ids;
+    for (auto &out : outputs) {
+      fetch_var_ids.insert(out->id);
+    }
+    FoldConstantSubgraphs(&program, fetch_var_ids, scope.get(), target);
+  }
   ctx->graph.reset(new hlir::framework::Graph(program, target));
 
   if (ctx->compile_options.use_default_passes) {
@@ -219,6 +235,42 @@ void CinnComputation::GetTensorData(const std::string &tname, void *data, size_t
   GetTensorData(t, data, size);
 }
 
+constexpr size_t CinnComputation::kTensorDataAlignment;
+
+void CinnComputation::BindTensorData(hlir::framework::Tensor &t, void *data, size_t size) {
+  CHECK(data) << "The bound memory should not be null";
+  CHECK_EQ(reinterpret_cast<uintptr_t>(data) % kTensorDataAlignment, 0)
+      << "The bound memory should be aligned to " << kTensorDataAlignment << " bytes";
+  CHECK_GE(size, t->shape().numel() * t->type().bytes());
+  auto buffer = t->get_buffer();
+  // the memory bound by the static memory plan is shared by many variables
+  CHECK(!buffer->is_external_memory() || context_->bound_buffers.count(buffer.get()))
+      << "The tensor uses the memory of another buffer, which can't be bound";
+  if (buffer->target().arch != context_->target.arch) {
+    buffer->SetTarget(context_->target);
+  }
+  buffer->BindExternalMemory(data, size);
+  context_->bound_buffers.insert(buffer.get());
+}
+
+void CinnComputation::BindTensorData(const std::string &tname, void *data, size_t size) {
+  hlir::framework::Tensor t = GetTensor(tname);
+  BindTensorData(t, data, size);
+}
+
+void CinnComputation::UnbindTensorData(hlir::framework::Tensor &t) {
+  auto buffer = t->get_buffer();
+  CHECK(context_->bound_buffers.count(buffer.get())) << "The tensor is not bound to user memory";
+  buffer->Free();
+  context_->bound_buffers.erase(buffer.get());
+  t->mutable_data(context_->target, t->type());
+}
+
+void CinnComputation::UnbindTensorData(const std::string &tname) {
+  hlir::framework::Tensor t = GetTensor(tname);
+  UnbindTensorData(t);
+}
+
 std::vector<hlir::framework::Tensor> CinnComputation::GetInputTensors() { return context_->inputs; }
 
 std::vector<hlir::framework::Tensor> CinnComputation::GetOutputTensors() { return context_->outputs; }
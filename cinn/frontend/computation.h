@@ -148,6 +148,40 @@ class CinnComputation {
    */
   void GetTensorData(const std::string &tname, void *data, size_t size);
 
+  //! the alignment in bytes required by BindTensorData
+  static constexpr size_t kTensorDataAlignment = 16;
+
+  /**
+   * bind a user owned memory buffer to a tensor as its data without copying, the inputs are read from and the outputs
+   * are written into the memory directly by Execute. The cached arguments of instructions refer to the buffer of
+   * the tensor rather than its memory, so they keep valid after binding.
+   * the memory should be on the device of the target, aligned to kTensorDataAlignment bytes and large enough to hold
+   * the tensor. It is still owned by the caller, who should keep it alive and not access it during Execute, until the
+   * tensor is unbound, bound to another memory or the computation is destroyed. The tensors sharing buffer with the
+   * tensor, such as the output of a reshape, use the memory as well.
+   * @param t the tensor
+   * @param data address of the memory buffer
+   * @param size size of the memory buffer
+   */
+  void BindTensorData(hlir::framework::Tensor &t, void *data, size_t size);
+  /**
+   * bind a user owned memory buffer to a tensor (specified by it's name) as its data without copying.
+   * @param tname name of the tensor
+   * @param data address of the memory buffer
+   * @param size size of the memory buffer
+   */
+  void BindTensorData(const std::string &tname, void *data, size_t size);
+  /**
+   * detach the user owned memory bound to a tensor, the tensor allocates its own memory again, whose data is undefined.
+   * @param t the tensor
+   */
+  void UnbindTensorData(hlir::framework::Tensor &t);
+  /**
+   * detach the user owned memory bound to a tensor (specified by it's name).
+   * @param tname name of the tensor
+   */
+  void UnbindTensorData(const std::string &tname);
+
   /**
    * run the compiled program
    */
@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <memory>
+
 #include "cinn/common/target.h"
 #include "cinn/frontend/decomposer/use_decomposer.h"
 #include "cinn/frontend/decomposer_registry.h"
@@ -102,6 +105,59 @@ TEST(cinn_computation, basic_cpu) {
   }
 }
 
+TEST(cinn_computation, bind_tensor_data_cpu) {
+  NetBuilder builder("bind");
+  constexpr int M = 32;
+  constexpr int N = 24;
+
+  auto a = builder.CreateInput(Float(32), {M, N}, "A");
+  auto b = builder.CreateInput(Float(32), {M, N}, "B");
+  auto c = builder.Add(a, b);
+  auto d = builder.Add(a, c);
+
+  auto target = common::DefaultHostTarget();
+  auto comp   = CinnComputation::BuildAndCompile(target, builder);
+
+  auto alloc = [](size_t size) {
+    return std::unique_ptr<float, decltype(&free)>(
+        reinterpret_cast<float *>(aligned_alloc(CinnComputation::kTensorDataAlignment, size)), &free);
+  };
+  size_t size = M * N * sizeof(float);
+  auto hostA  = alloc(size);
+  auto hostB  = alloc(size);
+  auto hostD  = alloc(size);
+  for (int i = 0; i < M * N; i++) {
+    hostA.get()[i] = static_cast<float>(rand()) / INT_MAX;
+    hostB.get()[i] = static_cast<float>(rand()) / INT_MAX;
+  }
+
+  comp->BindTensorData("A", hostA.get(), size);
+  comp->BindTensorData("B", hostB.get(), size);
+  comp->BindTensorData(d->id, hostD.get(), size);
+  ASSERT_EQ(comp->GetTensor("A")->data<float>(), hostA.get());
+
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    // the results are written into the bound memory directly
+    comp->Execute();
+    for (int i = 0; i < M * N; i++) {
+      ASSERT_NEAR(hostD.get()[i], hostA.get()[i] * 2 + hostB.get()[i], 1e-5);
+    }
+    // update the inputs in place for the next run
+    for (int i = 0; i < M * N; i++) {
+      hostA.get()[i] += 1.f;
+    }
+  }
+
+  comp->UnbindTensorData(d->id);
+  ASSERT_NE(comp->GetTensor(d->id)->data<float>(), hostD.get());
+  std::vector<float> result(M * N);
+  comp->Execute();
+  comp->GetTensorData(d->id, result.data(), size);
+  for (int i = 0; i < M * N; i++) {
+    ASSERT_NEAR(result[i], hostA.get()[i] * 2 + hostB.get()[i], 1e-5);
+  }
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(cinn_computation, basic_gpu) {
   NetBuilder builder("basic");
@@ -0,0 +1,171 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/constant_folding.h"
+
+#include <memory>
+#include <utility>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+bool IsFoldable(const Instruction& instr,
+                const std::unordered_set<std::string>& const_ids,
+                const std::unordered_set<std::string>& fetch_ids) {
+  // the ops with side effects or randomness have to run every time
+  static const std::unordered_set<std::string> unfoldable_ops = {
+      "custom_call", "uniform_random", "gaussian_random", "randint"};
+  if (instr->inputs.empty() || instr->outputs.empty() || unfoldable_ops.count(instr->op_type)) {
+    return false;
+  }
+  // the ops to be decomposed have no kernels to evaluate them
+  if (!hlir::framework::OpRegistry::Global()->Find(instr->op_type)) {
+    return false;
+  }
+  for (auto& input : instr->inputs) {
+    if (!const_ids.count(input->id)) {
+      return false;
+    }
+  }
+  for (auto& output : instr->outputs) {
+    if (fetch_ids.count(output->id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int FoldConstantSubgraphs(Program* program,
+                          const std::unordered_set<std::string>& fetch_ids,
+                          hlir::framework::Scope* scope,
+                          const common::Target& target) {
+  CHECK(program);
+  CHECK(scope);
+  std::unordered_set<std::string> feed_ids;
+  for (auto& var : program->GetInputs()) {
+    feed_ids.insert(var->id);
+  }
+
+  // collect the instructions computed from constants only in topological order
+  std::unordered_set<std::string> const_ids, folded_ids;
+  std::vector<int> folded_idxs;
+  for (int i = 0; i < program->size(); ++i) {
+    auto& instr = (*program)[i];
+    for (auto& input : instr->inputs) {
+      if (input.is_const() && !feed_ids.count(input->id) && scope->FindVar(input->id) &&
+          scope->GetTensor(input->id)->buffer()->memory) {
+        const_ids.insert(input->id);
+      }
+    }
+    if (!IsFoldable(instr, const_ids, fetch_ids)) {
+      continue;
+    }
+    folded_idxs.push_back(i);
+    for (auto& output : instr->outputs) {
+      const_ids.insert(output->id);
+      folded_ids.insert(output->id);
+    }
+  }
+  if (folded_idxs.empty()) {
+    return 0;
+  }
+
+  // the folded variables used by the rest of the program become constants
+  std::unordered_set<int> folded_idx_set(folded_idxs.begin(), folded_idxs.end());
+  std::unordered_set<std::string> used_ids, new_const_ids;
+  for (int i = 0; i < program->size(); ++i) {
+    if (folded_idx_set.count(i)) {
+      continue;
+    }
+    for (auto& input : (*program)[i]->inputs) {
+      used_ids.insert(input->id);
+      if (folded_ids.count(input->id)) {
+        new_const_ids.insert(input->id);
+      }
+    }
+  }
+
+  // evaluate the folded instructions in a temporary scope sharing the constant tensors, so that the intermediate
+  // tensors are released with it, the folded instructions whose outputs are not used are just dead code
+  if (!new_const_ids.empty()) {
+    NetBuilder sub_builder("constant_folding_builder");
+    for (int idx : folded_idxs) {
+      sub_builder.AppendInstruction((*program)[idx]);
+    }
+    auto sub_program = sub_builder.Build();
+    VLOG(3) << "Fold " << folded_idxs.size() << " constant instructions:\n" << sub_program;
+
+    auto sub_scope = std::make_shared<hlir::framework::Scope>();
+    for (auto& id : const_ids) {
+      if (!folded_ids.count(id)) {
+        *sub_scope->Var<hlir::framework::Tensor>(id) = scope->GetTensor(id);
+      }
+    }
+    auto graph = std::make_shared<hlir::framework::Graph>(sub_program, new_const_ids, target);
+    hlir::framework::ApplyPass(graph.get(), "InferShape");
+    hlir::framework::ApplyPasses(graph.get(), DefaultOpFusionPasses());
+    hlir::framework::BuildScope(target, graph, sub_scope);
+    hlir::framework::GraphCompiler graph_compiler(target, sub_scope, graph);
+    hlir::framework::GraphCompiler::CompileOptions options;
+    auto fetch_var_ids   = new_const_ids;
+    auto runtime_program = graph_compiler.Build(options, std::move(fetch_var_ids)).runtime_program;
+    runtime_program->Execute();
+
+    for (auto& id : new_const_ids) {
+      *scope->Var<hlir::framework::Tensor>(id) = sub_scope->GetTensor(id);
+    }
+  }
+
+  // release the constants only used by the folded instructions
+  for (auto& id : const_ids) {
+    if (!folded_ids.count(id) && !used_ids.count(id) && !fetch_ids.count(id)) {
+      VLOG(4) << "Erase the constant " << id << " which is not used after folding";
+      scope->EraseVar(id);
+    }
+  }
+
+  NetBuilder builder("constant_folding_builder");
+  for (auto& var : program->GetInputs()) {
+    builder.CreateInput(var);
+  }
+  for (int i = 0; i < program->size(); ++i) {
+    if (folded_idx_set.count(i)) {
+      continue;
+    }
+    auto& instr = (*program)[i];
+    for (auto& input : instr->inputs) {
+      if (new_const_ids.count(input->id)) {
+        input.set_const(true);
+      }
+    }
+    builder.AppendInstruction(instr);
+  }
+  *program = builder.Build();
+  return folded_idxs.size();
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,44 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * Evaluate the subgraphs of \p program computed from constants only at compile time, such as the reshapes, transposes
+ * and casts of weights. The constants are the constant variables whose tensors exist in \p scope.
+ *
+ * The folded instructions are compiled and run once on \p target, their outputs used by the rest of the program are
+ * stored into \p scope as new constants, and the folded instructions are removed from \p program. The constants not
+ * used any more are erased from \p scope to release their memory. The instructions whose outputs are in \p fetch_ids
+ * are not folded.
+ *
+ * @return The number of the folded instructions.
+ */
+int FoldConstantSubgraphs(Program* program,
+                          const std::unordered_set<std::string>& fetch_ids,
+                          hlir::framework::Scope* scope,
+                          const common::Target& target);
+
+}  // namespace frontend
+}  // namespace cinn
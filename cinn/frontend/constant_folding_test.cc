@@ -0,0 +1,90 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/constant_folding.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+
+namespace cinn {
+namespace frontend {
+
+TEST(FoldConstantSubgraphs, fold_weight_math) {
+  //    <w>                         <w'>
+  //     |                            |
+  // transpose                        |
+  //     |                 =>         |
+  //   scale      <x>                 |    <x>
+  //       \      /                    \   /
+  //      elementwise_add          elementwise_add
+  NetBuilder builder("net_builder");
+  auto x = builder.CreateInput(Float(32), {8, 4}, "x");
+  Placeholder w(Float(32), {4, 8}, "w", true);
+  auto transpose = builder.Transpose(w, {1, 0});
+  auto scale     = builder.Scale(transpose, 2.0f, 1.0f);
+  auto out       = builder.Add(x, scale);
+  auto program   = builder.Build();
+  ASSERT_EQ(program.size(), 3);
+
+  auto target = common::DefaultHostTarget();
+  hlir::framework::Scope scope;
+  auto w_tensor = absl::get<hlir::framework::Tensor>(*scope.Var<hlir::framework::Tensor>("w"));
+  w_tensor->Resize(hlir::framework::Shape({4, 8}));
+  auto* w_data = w_tensor->mutable_data<float>(target);
+  for (int i = 0; i < 32; ++i) {
+    w_data[i] = i;
+  }
+
+  ASSERT_EQ(FoldConstantSubgraphs(&program, {out->id}, &scope, target), 2);
+  ASSERT_EQ(program.size(), 1);
+  ASSERT_EQ(program[0]->op_type, "elementwise_add");
+  ASSERT_TRUE(program[0]->inputs[1].is_const());
+
+  // the folded constant replaces the weight and the intermediate result
+  ASSERT_EQ(scope.FindVar("w"), nullptr);
+  ASSERT_EQ(scope.FindVar(transpose->id), nullptr);
+  auto folded = scope.GetTensor(scale->id);
+  ASSERT_EQ(folded->shape().data(), std::vector<int>({8, 4}));
+  const float* folded_data = folded->data<float>();
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      ASSERT_FLOAT_EQ(folded_data[i * 4 + j], (j * 8 + i) * 2.0f + 1.0f);
+    }
+  }
+}
+
+TEST(FoldConstantSubgraphs, keep_fetched) {
+  NetBuilder builder("net_builder");
+  Placeholder w(Float(32), {4, 8}, "w", true);
+  auto scale   = builder.Scale(w, 2.0f);
+  auto program = builder.Build();
+
+  auto target = common::DefaultHostTarget();
+  hlir::framework::Scope scope;
+  auto w_tensor = absl::get<hlir::framework::Tensor>(*scope.Var<hlir::framework::Tensor>("w"));
+  w_tensor->Resize(hlir::framework::Shape({4, 8}));
+  w_tensor->mutable_data<float>(target);
+
+  ASSERT_EQ(FoldConstantSubgraphs(&program, {scale->id}, &scope, target), 0);
+  ASSERT_EQ(program.size(), 1);
+  ASSERT_NE(scope.FindVar("w"), nullptr);
+}
+
+}  // namespace frontend
+}  // namespace cinn
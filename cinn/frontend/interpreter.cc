@@ -16,6 +16,7 @@
 
 #include "cinn/auto_schedule/auto_tuner.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/frontend/constant_folding.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph.h"
@@ -25,6 +26,7 @@
 #include "cinn/runtime/flags.h"
 
 DECLARE_bool(enable_auto_tuner);
+DECLARE_bool(cinn_fold_constant_subgraphs);
 
 namespace cinn::frontend {
 
@@ -108,6 +110,9 @@ void Interpreter::Impl::Build(const Target& target, const std::string& model_nam
     fetch_var_ids.insert(var_map_.at(name)->id);
   }
 
+  if (FLAGS_cinn_fold_constant_subgraphs) {
+    FoldConstantSubgraphs(program_.get(), fetch_var_ids, scope_.get(), target);
+  }
   auto graph = Optimize(program_.get(), fetch_var_ids, target);
   // auto graph                 = std::make_shared<hlir::framework::Graph>(*program_, target);
   graph->attrs["model_name"] = std::make_shared<absl::any>(model_name);
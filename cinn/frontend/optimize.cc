@@ -46,7 +46,9 @@ OptimizeOptions DefaultTrainingOptimizeOptions() {
   if (FLAGS_cinn_use_fill_constant_folding) {
     options.program_passes.emplace_back("FillConstantFolding");
   }
+  options.program_passes.emplace_back("AlgebraicSimplification");
   options.program_passes.emplace_back("RemoveIdentity");
+  options.program_passes.emplace_back("CommonSubexpressionElimination");
   options.program_passes.emplace_back("DeadCodeEliminate");
   if (FLAGS_cinn_open_fusion_optimize) {
     if (FLAGS_cinn_use_new_fusion_pass) {
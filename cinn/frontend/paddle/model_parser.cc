@@ -14,7 +14,17 @@
 
 #include "cinn/frontend/paddle/model_parser.h"
 
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <numeric>
 #include <vector>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -23,6 +33,11 @@
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/common.h"
 #include "cinn/frontend/paddle/compatible_pb.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_bool(cinn_mmap_params);
+DECLARE_int32(cinn_param_load_threads);
 
 namespace cinn::frontend::paddle {
 
@@ -46,8 +61,32 @@ int SizeOfType(framework_proto::VarType::Type type) {
   return -1;
 }
 
-void TensorFromStream(std::istream &is, hlir::framework::_Tensor_ *tensor, const common::Target &target) {
+namespace {
+
+// the CINN type of the tensor data of a paddle type
+common::Type ToCinnType(framework_proto::VarType::Type type) {
   using Type = framework_proto::VarType::Type;
+  switch (static_cast<int>(type)) {
+    case Type::VarType_Type_FP32:
+      return Float(32);
+    case Type::VarType_Type_INT8:
+      return Int(8);
+    case Type::VarType_Type_INT16:
+      return Int(16);
+    case Type::VarType_Type_INT32:
+      return Int(32);
+    case Type::VarType_Type_INT64:
+      return Int(64);
+    default:
+      LOG(FATAL) << "unknown type " << type;
+  }
+  return common::Type();
+}
+
+// Read the header of a tensor and resize the tensor, the data follows the header. The Reader is a std::istream or
+// a MemoryReader.
+template <typename Reader>
+framework_proto::VarType::TensorDesc ReadTensorDesc(Reader &is, hlir::framework::_Tensor_ *tensor) {
   uint32_t version;
   is.read(reinterpret_cast<char *>(&version), sizeof(version));
   CHECK_EQ(version, 0U) << "Only version 0 is supported";
@@ -63,31 +102,139 @@ void TensorFromStream(std::istream &is, hlir::framework::_Tensor_ *tensor, const
     CHECK(desc.ParseFromArray(buf.get(), size)) << "Cannot parse tensor desc";
   }
 
-  // read tensor
   std::vector<int32_t> dims_vec;
   std::copy(desc.dims().begin(), desc.dims().end(), std::back_inserter(dims_vec));
   hlir::framework::Shape dims(dims_vec);
   tensor->Resize(dims);
-  void *buf;
+  return desc;
+}
+
+// Skip the LoD information before a tensor.
+template <typename Reader>
+void SkipLoD(Reader &is) {
+  uint32_t version{};
+  is.read(reinterpret_cast<char *>(&version), sizeof(version));
+  VLOG(3) << "model version " << version;
+
+  uint64_t lod_level{};
+  is.read(reinterpret_cast<char *>(&lod_level), sizeof(lod_level));
+
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t size;
+    is.read(reinterpret_cast<char *>(&size), sizeof(size));
+    std::vector<uint64_t> tmp(size / sizeof(uint64_t));
+    is.read(reinterpret_cast<char *>(tmp.data()), static_cast<std::streamsize>(size));
+    // lod[i] = tmp;
+  }
+}
+
+// A whole file mapped into memory privately, the pages are shared with the page cache and other processes mapping
+// the same file until they are written.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) : path_(path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    CHECK_GE(fd, 0) << "failed to open file " << path;
+    struct stat file_stat;
+    CHECK_EQ(fstat(fd, &file_stat), 0) << "failed to stat file " << path;
+    size_ = file_stat.st_size;
+    if (size_ > 0) {
+      void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      CHECK(data != MAP_FAILED) << "failed to map file " << path;
+      data_ = static_cast<char *>(data);
+    }
+    close(fd);
+  }
+  ~MappedFile() {
+    if (data_) {
+      munmap(data_, size_);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  char *data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string &path() const { return path_; }
+
+ private:
+  std::string path_;
+  char *data_  = nullptr;
+  size_t size_ = 0;
+};
+
+// Read a mapped file sequentially like a std::istream.
+class MemoryReader {
+ public:
+  explicit MemoryReader(const std::shared_ptr<MappedFile> &file) : file_(file) {}
+
+  void read(char *dst, size_t size) { std::memcpy(dst, Skip(size), size); }
+
+  // skip \p size bytes and return their address
+  char *Skip(size_t size) {
+    CHECK_LE(size, file_->size() - offset_) << "Unexpected end of file " << file_->path();
+    char *data = file_->data() + offset_;
+    offset_ += size;
+    return data;
+  }
+
+  bool eof() const { return offset_ == file_->size(); }
+  const std::shared_ptr<MappedFile> &file() const { return file_; }
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+  size_t offset_ = 0;
+};
+
+// The alignment of the tensor data bound to a mapped file directly, which is assumed by the scalar loads and stores
+// of the X86 codegen.
+constexpr size_t kMappedDataAlignment = 8;
+
+void TensorFromMemory(MemoryReader &reader, hlir::framework::_Tensor_ *tensor, const common::Target &target) {
+  auto desc       = ReadTensorDesc(reader, tensor);
+  auto type       = ToCinnType(desc.data_type());
+  size_t size     = tensor->shape().numel() * SizeOfType(desc.data_type());
+  char *data      = reader.Skip(size);
+  bool is_aligned = reinterpret_cast<uintptr_t>(data) % kMappedDataAlignment == 0;
+  if (target.arch == Target::Arch::X86 && is_aligned && size > 0) {
+    // point the tensor to the mapped data, the mapping lives as long as any tensor bound to it
+    auto buffer = std::make_shared<hlir::framework::Buffer>(target);
+    buffer->BindExternalMemory(data, size, reader.file());
+    tensor->set_buffer(buffer);
+    tensor->Resize(tensor->shape());
+    tensor->set_type(type);
+  } else if (target.arch == Target::Arch::X86) {
+    std::memcpy(tensor->mutable_data(target, type), data, size);
+  } else if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    if (desc.data_type() != framework_proto::VarType_Type_FP32) LOG(FATAL) << "[CUDA] The type is not fp32!!";
+    auto *dst = tensor->mutable_data<float>(target);
+    tensor->set_type(Float(32));
+    CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(dst), data, size, cudaMemcpyHostToDevice));
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+void LoadLoDTensorFromMemory(MemoryReader &reader, hlir::framework::Variable *var, const common::Target &target) {
+  auto &tensor = absl::get<hlir::framework::Tensor>(*var);
+  SkipLoD(reader);
+  TensorFromMemory(reader, tensor.operator->(), target);
+}
+
+}  // namespace
+
+void TensorFromStream(std::istream &is, hlir::framework::_Tensor_ *tensor, const common::Target &target) {
+  using Type = framework_proto::VarType::Type;
+  auto desc   = ReadTensorDesc(is, tensor);
   size_t size = tensor->shape().numel() * SizeOfType(desc.data_type());
   // alllocate memory
   if (target.arch == Target::Arch::X86) {
-    switch (static_cast<int>(desc.data_type())) {
-#define SET_TENSOR(desc, type, precision)     \
-  case Type::VarType_Type_##desc:             \
-    buf = tensor->mutable_data<type>(target); \
-    tensor->set_type(precision);              \
-    break
-
-      SET_TENSOR(FP32, float, Float(32));
-      SET_TENSOR(INT8, int8_t, Int(8));
-      SET_TENSOR(INT16, int16_t, Int(16));
-      SET_TENSOR(INT32, int32_t, Int(32));
-      SET_TENSOR(INT64, int64_t, Int(64));
-#undef SET_TENSOR
-      default:
-        LOG(FATAL) << "unknown type " << desc.data_type();
-    }
+    void *buf = tensor->mutable_data(target, ToCinnType(desc.data_type()));
     // tensor->set_persistable(true);
     is.read(static_cast<char *>(buf), size);
   } else if (target.arch == Target::Arch::NVGPU) {
@@ -110,22 +257,8 @@ void TensorFromStream(std::istream &is, hlir::framework::_Tensor_ *tensor, const
 
 void LoadLoDTensor(std::istream &is, hlir::framework::Variable *var, const common::Target &target) {
   auto &tensor = absl::get<hlir::framework::Tensor>(*var);
-  uint32_t version{};
-  is.read(reinterpret_cast<char *>(&version), sizeof(version));
-  VLOG(3) << "model version " << version;
-
   // Load LoD information
-  uint64_t lod_level{};
-  is.read(reinterpret_cast<char *>(&lod_level), sizeof(lod_level));
-
-  for (uint64_t i = 0; i < lod_level; ++i) {
-    uint64_t size;
-    is.read(reinterpret_cast<char *>(&size), sizeof(size));
-    std::vector<uint64_t> tmp(size / sizeof(uint64_t));
-    is.read(reinterpret_cast<char *>(tmp.data()), static_cast<std::streamsize>(size));
-    // lod[i] = tmp;
-  }
-
+  SkipLoD(is);
   TensorFromStream(is, tensor.operator->(), target);
 }
 
@@ -157,11 +290,50 @@ void LoadParams(const std::string &path) {}
 
 // Load directly to CPU, and latter transfer to other devices.
 void LoadParam(const std::string &path, hlir::framework::Variable *out, const common::Target &target) {
+  if (FLAGS_cinn_mmap_params) {
+    MemoryReader reader(std::make_shared<MappedFile>(path));
+    LoadLoDTensorFromMemory(reader, out, target);
+    return;
+  }
   std::ifstream fin(path, std::ios::binary);
   CHECK(fin.is_open()) << "failed to open file " << path;
   LoadLoDTensor(fin, out, target);
 }
 
+ParamLoadStats LoadParamsInParallel(const std::vector<std::string> &paths,
+                                    const std::vector<hlir::framework::Variable *> &outs,
+                                    const common::Target &target) {
+  CHECK_EQ(paths.size(), outs.size());
+  utils::Timer timer;
+  timer.Start();
+  std::vector<int64_t> num_bytes(paths.size(), 0);
+#ifdef CINN_WITH_CUDA
+  // the workers of the task pool don't inherit the device selected by the calling thread
+  int device_id = 0;
+  if (target.arch == Target::Arch::NVGPU) {
+    CUDA_CALL(cudaGetDevice(&device_id));
+  }
+#endif
+  // the variables are created by the caller, so the workers only write the tensors of their own
+  auto load_param = [&](int index) {
+#ifdef CINN_WITH_CUDA
+    if (target.arch == Target::Arch::NVGPU) {
+      CUDA_CALL(cudaSetDevice(device_id));
+    }
+#endif
+    LoadParam(paths[index], outs[index], target);
+    auto &tensor     = absl::get<hlir::framework::Tensor>(*outs[index]);
+    num_bytes[index] = tensor->shape().numel() * tensor->type().bytes();
+  };
+  utils::parallel_for(0, paths.size(), load_param, std::max(FLAGS_cinn_param_load_threads, 1));
+
+  ParamLoadStats stats;
+  stats.num_files = paths.size();
+  stats.num_bytes = std::accumulate(num_bytes.begin(), num_bytes.end(), int64_t{0});
+  stats.seconds   = timer.Stop() / 1000.;
+  return stats;
+}
+
 bool IsPersistable(const cpp::VarDesc &var) {
   if (var.Persistable() && var.GetType() != cpp::VarDescAPI::Type::FEED_MINIBATCH &&
       var.GetType() != cpp::VarDescAPI::Type::FETCH_LIST && var.GetType() != cpp::VarDescAPI::Type::RAW) {
@@ -204,6 +376,14 @@ void LoadCombinedParamsPb(const std::string &path,
   if (params_from_memory) {
     std::stringstream fin(path, std::ios::in | std::ios::binary);
     load_var_func(fin);
+  } else if (FLAGS_cinn_mmap_params) {
+    MemoryReader reader(std::make_shared<MappedFile>(path));
+    for (size_t i = 0; i < paramlist.size(); ++i) {
+      auto *var = scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(paramlist[i]));
+      LoadLoDTensorFromMemory(reader, var, target);
+    }
+    CHECK(reader.eof()) << "You are not allowed to load partial data via"
+                        << " LoadCombinedParamsPb, use LoadParam instead.";
   } else {
     std::ifstream fin(path, std::ios::binary);
     CHECK(fin.is_open());
@@ -218,7 +398,8 @@ void LoadModelPb(const std::string &model_dir,
                  cpp::ProgramDesc *cpp_prog,
                  bool combined,
                  bool model_from_memory,
-                 const common::Target &target) {
+                 const common::Target &target,
+                 ParamLoadStats *stats) {
   CHECK(cpp_prog);
   CHECK(scope);
   cpp_prog->ClearBlocks();
@@ -244,25 +425,36 @@ void LoadModelPb(const std::string &model_dir,
   CHECK(!(!combined && model_from_memory)) << "If you want use the model_from_memory,"
                                            << " you should load the combined model using cfg.set_model_buffer "
                                               "interface.";
+  ParamLoadStats load_stats;
   if (combined) {
+    utils::Timer timer;
+    timer.Start();
     LoadCombinedParamsPb(param_file_temp, scope, *cpp_prog, model_from_memory, target);
+    load_stats.seconds   = timer.Stop() / 1000.;
+    load_stats.num_files = model_from_memory ? 0 : 1;
+    auto &main_block     = *cpp_prog->GetBlock<cpp::BlockDesc>(0);
+    for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+      auto &var = *main_block.GetVar<cpp::VarDesc>(i);
+      if (!IsPersistable(var)) continue;
+      auto tensor = scope->GetTensor(utils::TransValidVarName(var.Name()));
+      load_stats.num_bytes += tensor->shape().numel() * tensor->type().bytes();
+    }
   } else {
+    std::vector<std::string> param_paths;
+    std::vector<hlir::framework::Variable *> param_vars;
     auto main_block = pb_proto_prog.blocks(0);
     for (auto &var : main_block.vars()) {
       if (var.name() == "feed" || var.name() == "fetch" || !var.persistable()) continue;
-
-      std::string file_path = model_dir + "/" + var.name();
-      VLOG(4) << "reading weight " << var.name();
-
-      std::ifstream file(file_path, std::ios::binary);
-      switch (var.type().type()) {
-        case framework_proto::VarType_Type_LOD_TENSOR:
-          LoadLoDTensor(file, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
-          break;
-        default:
-          LOG(FATAL) << "unknown weight type";
-      }
+      CHECK(var.type().type() == framework_proto::VarType_Type_LOD_TENSOR) << "unknown weight type";
+      param_paths.push_back(model_dir + "/" + var.name());
+      param_vars.push_back(scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())));
     }
+    load_stats = LoadParamsInParallel(param_paths, param_vars, target);
+  }
+  VLOG(1) << "Load " << load_stats.num_files << " parameter files of " << load_stats.num_bytes << " bytes in "
+          << load_stats.seconds << " seconds";
+  if (stats) {
+    *stats = load_stats;
   }
 
   VLOG(4) << "Load protobuf model in [" << model_dir << "] successfully";
@@ -29,7 +29,17 @@
 namespace cinn::frontend::paddle {
 namespace framework_proto = ::cinn::frontend::paddle::proto;
 
-// Read a model and files of parameters in pb format.
+// The breakdown of loading the parameters of a model.
+struct ParamLoadStats {
+  // the number of parameter files
+  int num_files = 0;
+  // the bytes of the tensor data
+  int64_t num_bytes = 0;
+  // the wall time of loading
+  double seconds = 0;
+};
+
+// Read a model and files of parameters in pb format, \p stats gets the breakdown of loading the parameters if given.
 void LoadModelPb(const std::string& model_dir,
                  const std::string& model_file,
                  const std::string& param_file,
@@ -37,7 +47,8 @@ void LoadModelPb(const std::string& model_dir,
                  cpp::ProgramDesc* cpp_prog,
                  bool combined                = true,
                  bool model_from_memory       = false,
-                 const common::Target& target = common::DefaultHostTarget());
+                 const common::Target& target = common::DefaultHostTarget(),
+                 ParamLoadStats* stats        = nullptr);
 
 // Read a __model__ file.
 std::unique_ptr<framework_proto::ProgramDesc> LoadProgram(const std::string& path, bool program_from_memory = false);
@@ -50,6 +61,11 @@ void LoadParams(const std::string& path);
 // Load a single parameter to an output tensor.
 void LoadParam(const std::string& path, hlir::framework::Variable* out, const common::Target& target);
 
+// Load the parameter files \p paths to \p outs respectively on FLAGS_cinn_param_load_threads threads at most.
+ParamLoadStats LoadParamsInParallel(const std::vector<std::string>& paths,
+                                    const std::vector<hlir::framework::Variable*>& outs,
+                                    const common::Target& target);
+
 void LoadCombinedParamsPb(const std::string& path,
                           hlir::framework::Scope* scope,
                           const pb::ProgramDesc& prog,
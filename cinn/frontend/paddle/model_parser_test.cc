@@ -17,7 +17,13 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
 DEFINE_string(model_dir, "<NOTEXIST>", "model directory path");
+DECLARE_bool(cinn_mmap_params);
 
 namespace cinn::frontend::paddle {
 
@@ -42,4 +48,94 @@ TEST(LoadModelPb, naive_model) {
   // fetch
 }
 
+// Write a LoDTensor without LoD, whose header takes \p padding_dims extra dims of 1 to shift the data.
+void WriteParam(const std::string& path, const std::vector<float>& values, int padding_dims) {
+  framework_proto::VarType::TensorDesc desc;
+  desc.set_data_type(framework_proto::VarType_Type_FP32);
+  for (int i = 0; i < padding_dims; ++i) {
+    desc.add_dims(1);
+  }
+  desc.add_dims(values.size());
+  std::string desc_str = desc.SerializeAsString();
+
+  std::ofstream os(path, std::ios::binary);
+  uint32_t version   = 0;
+  uint64_t lod_level = 0;
+  int32_t desc_size  = desc_str.size();
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  os.write(reinterpret_cast<const char*>(&lod_level), sizeof(lod_level));
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  os.write(reinterpret_cast<const char*>(&desc_size), sizeof(desc_size));
+  os.write(desc_str.data(), desc_str.size());
+  os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+}
+
+TEST(LoadParam, mmap) {
+  std::vector<float> values(100);
+  for (int i = 0; i < values.size(); ++i) {
+    values[i] = i * 0.5f;
+  }
+  bool mmap_params = FLAGS_cinn_mmap_params;
+  int num_bound    = 0;
+  // the data is aligned or not depending on the size of the header
+  for (int padding_dims = 0; padding_dims < 8; ++padding_dims) {
+    std::string path = "./test_load_param_" + std::to_string(padding_dims);
+    WriteParam(path, values, padding_dims);
+    for (bool use_mmap : {true, false}) {
+      FLAGS_cinn_mmap_params = use_mmap;
+      hlir::framework::Scope scope;
+      auto* var = scope.Var<hlir::framework::Tensor>("param");
+      LoadParam(path, var, common::DefaultHostTarget());
+
+      auto tensor = scope.GetTensor("param");
+      ASSERT_EQ(tensor->shape().numel(), values.size());
+      ASSERT_EQ(tensor->type(), Float(32));
+      const float* data = tensor->data<float>();
+      for (int i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(data[i], values[i]);
+      }
+      if (!use_mmap) {
+        ASSERT_FALSE(tensor->get_buffer()->is_external_memory());
+      } else if (tensor->get_buffer()->is_external_memory()) {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % 8, 0);
+        ++num_bound;
+        // writing the bound data doesn't change the file
+        tensor->mutable_data<float>(common::DefaultHostTarget())[0] = -1.f;
+      }
+    }
+    // the file is intact
+    FLAGS_cinn_mmap_params = true;
+    hlir::framework::Scope scope;
+    auto* var = scope.Var<hlir::framework::Tensor>("param");
+    LoadParam(path, var, common::DefaultHostTarget());
+    ASSERT_EQ(scope.GetTensor("param")->data<float>()[0], values[0]);
+    std::remove(path.c_str());
+  }
+  FLAGS_cinn_mmap_params = mmap_params;
+  ASSERT_GT(num_bound, 0);
+}
+
+TEST(LoadParamsInParallel, basic) {
+  std::vector<std::string> paths;
+  std::vector<hlir::framework::Variable*> outs;
+  hlir::framework::Scope scope;
+  for (int i = 0; i < 20; ++i) {
+    paths.push_back("./test_load_params_" + std::to_string(i));
+    WriteParam(paths.back(), std::vector<float>(i + 1, i), i % 4);
+    outs.push_back(scope.Var<hlir::framework::Tensor>("param_" + std::to_string(i)));
+  }
+  auto stats = LoadParamsInParallel(paths, outs, common::DefaultHostTarget());
+  ASSERT_EQ(stats.num_files, 20);
+  ASSERT_EQ(stats.num_bytes, 210 * sizeof(float));
+  ASSERT_GE(stats.seconds, 0.);
+  for (int i = 0; i < 20; ++i) {
+    auto tensor = scope.GetTensor("param_" + std::to_string(i));
+    ASSERT_EQ(tensor->shape().numel(), i + 1);
+    for (int j = 0; j <= i; ++j) {
+      ASSERT_EQ(tensor->data<float>()[j], i);
+    }
+    std::remove(paths[i].c_str());
+  }
+}
+
 }  // namespace cinn::frontend::paddle
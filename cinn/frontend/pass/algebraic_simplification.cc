@@ -0,0 +1,328 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/type.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "glog/logging.h"
+
+namespace cinn::frontend::pass {
+
+using cinn::utils::ShapeType;
+
+// AlgebraicSimplificationPass rewrites the instructions which compute their input unchanged or can be merged
+// into the instruction producing their input:
+//
+//   x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1  =>  identity(x)
+//   scale(x, 1, 0)                            =>  identity(x)
+//   scale(scale(x, a1, b1), a2, b2)           =>  scale(x, a2 * a1, a2 * b1 + b2)
+//   cast(cast(x, t1), t2)                     =>  cast(x, t2) if t1 holds all the values of x losslessly
+//   reshape(reshape(x))                       =>  reshape(x)
+//   transpose(transpose(x, p1), p2)           =>  identity(x) if p2 is the inverse of p1
+//   x + broadcast_to(s)                       =>  x + s if s has a single element
+//   reduce(x) over the axes of extent 1       =>  identity(x) or reshape(x)
+//
+// The rewritten instructions keep their outputs, so the fetched variables are untouched. The identities are removed
+// by RemoveIdentity and the instructions not used any more by DeadCodeEliminate.
+class AlgebraicSimplificationPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    std::unordered_map<std::string, Instruction> out2instr;
+    int num_rewrites = 0;
+    for (int i = 0; i < program->size(); ++i) {
+      auto& instr = (*program)[i];
+      if (Simplify(out2instr, &instr)) {
+        VLOG(4) << "Simplify the " << i << "-th instruction to " << instr;
+        ++num_rewrites;
+      }
+      for (auto& output : instr->outputs) {
+        out2instr[output->id] = instr;
+      }
+    }
+    VLOG(3) << "Total simplify " << num_rewrites << " instructions.";
+  }
+
+ private:
+  using OutputToOpMap = std::unordered_map<std::string, Instruction>;
+
+  bool Simplify(const OutputToOpMap& out2instr, Instruction* instr) const {
+    const auto& op_type = (*instr)->op_type;
+    if (op_type == "elementwise_add" || op_type == "elementwise_mul" || op_type == "substract" ||
+        op_type == "divide") {
+      return SimplifyElementwise(out2instr, instr);
+    } else if (op_type == "scale") {
+      return SimplifyScale(out2instr, instr);
+    } else if (op_type == "cast") {
+      return SimplifyCast(out2instr, instr);
+    } else if (op_type == "reshape") {
+      return SimplifyReshape(out2instr, instr);
+    } else if (op_type == "transpose") {
+      return SimplifyTranspose(out2instr, instr);
+    } else if (op_type == "reduce_sum" || op_type == "reduce_prod" || op_type == "reduce_max" ||
+               op_type == "reduce_min" || op_type == "reduce_all" || op_type == "reduce_any") {
+      return SimplifyReduce(instr);
+    }
+    return false;
+  }
+
+  bool SimplifyElementwise(const OutputToOpMap& out2instr, Instruction* instr) const {
+    auto& inputs     = (*instr)->inputs;
+    const auto& out  = (*instr)->outputs[0];
+    const auto& type = (*instr)->op_type;
+    // x op c => x when c is the identity element of op, and x op c is commutative for add and mul
+    float identity_value   = (type == "elementwise_add" || type == "substract") ? 0.f : 1.f;
+    bool is_commutative    = type == "elementwise_add" || type == "elementwise_mul";
+    auto is_identity_value = [&](const Variable& var) {
+      float value;
+      return GetConstantValue(out2instr, var, &value) && value == identity_value;
+    };
+    for (int x_idx : {0, 1}) {
+      if (x_idx == 1 && !is_commutative) {
+        break;
+      }
+      const auto& x = inputs[x_idx];
+      if (is_identity_value(inputs[1 - x_idx]) && x->shape == out->shape && x->type == out->type) {
+        ReplaceWithIdentity(instr, x);
+        return true;
+      }
+    }
+
+    // x op broadcast_to(s) => x op s when s has a single element, as the elementwise ops broadcast it as well
+    bool updated = false;
+    for (int s_idx : {0, 1}) {
+      auto iter = out2instr.find(inputs[s_idx]->id);
+      if (iter == out2instr.end() || iter->second->op_type != "broadcast_to") {
+        continue;
+      }
+      const auto& scalar = iter->second->inputs[0];
+      const auto& other  = inputs[1 - s_idx];
+      bool is_scalar     = std::all_of(scalar->shape.begin(), scalar->shape.end(), [](int dim) { return dim == 1; });
+      if (is_scalar && scalar->shape.size() <= other->shape.size() && other->shape == out->shape &&
+          scalar->type == other->type) {
+        inputs[s_idx] = scalar;
+        instr->SetAttr<int>("axis", -1);
+        updated = true;
+      }
+    }
+    return updated;
+  }
+
+  bool SimplifyScale(const OutputToOpMap& out2instr, Instruction* instr) const {
+    // represent scale(x) by a * x + b
+    auto get_linear = [](const Instruction& scale, float* a, float* b) {
+      *a = GetAttrOr<float>(scale, "scale", 1.f);
+      *b = GetAttrOr<float>(scale, "bias", 0.f);
+      if (!GetAttrOr<bool>(scale, "bias_after_scale", true)) {
+        *b *= *a;
+      }
+    };
+    float a, b;
+    get_linear(*instr, &a, &b);
+    auto iter = out2instr.find((*instr)->inputs[0]->id);
+    if (iter != out2instr.end() && iter->second->op_type == "scale") {
+      float inner_a, inner_b;
+      get_linear(iter->second, &inner_a, &inner_b);
+      (*instr)->inputs[0] = iter->second->inputs[0];
+      instr->SetAttr<float>("scale", a * inner_a);
+      instr->SetAttr<float>("bias", a * inner_b + b);
+      instr->SetAttr<bool>("bias_after_scale", true);
+      (*instr)->attrs_ordered.clear();
+      if (a * inner_a == 1.f && a * inner_b + b == 0.f) {
+        ReplaceWithIdentity(instr, (*instr)->inputs[0]);
+      }
+      return true;
+    }
+    if (a == 1.f && b == 0.f) {
+      ReplaceWithIdentity(instr, (*instr)->inputs[0]);
+      return true;
+    }
+    return false;
+  }
+
+  bool SimplifyCast(const OutputToOpMap& out2instr, Instruction* instr) const {
+    const auto& x   = (*instr)->inputs[0];
+    const auto& out = (*instr)->outputs[0];
+    if (x->type == out->type) {
+      ReplaceWithIdentity(instr, x);
+      return true;
+    }
+    auto iter = out2instr.find(x->id);
+    if (iter == out2instr.end() || iter->second->op_type != "cast" ||
+        !IsLosslessCast(iter->second->inputs[0]->type, x->type)) {
+      return false;
+    }
+    const auto& origin = iter->second->inputs[0];
+    if (origin->type == out->type) {
+      ReplaceWithIdentity(instr, origin);
+    } else {
+      (*instr)->inputs[0] = origin;
+    }
+    return true;
+  }
+
+  bool SimplifyReshape(const OutputToOpMap& out2instr, Instruction* instr) const {
+    const auto& out = (*instr)->outputs[0];
+    auto iter       = out2instr.find((*instr)->inputs[0]->id);
+    bool updated    = false;
+    if (iter != out2instr.end() && iter->second->op_type == "reshape") {
+      (*instr)->inputs[0] = iter->second->inputs[0];
+      updated             = true;
+    }
+    if ((*instr)->inputs[0]->shape == out->shape) {
+      ReplaceWithIdentity(instr, (*instr)->inputs[0]);
+      updated = true;
+    }
+    return updated;
+  }
+
+  bool SimplifyTranspose(const OutputToOpMap& out2instr, Instruction* instr) const {
+    auto is_identity_perm = [](const ShapeType& perm) {
+      for (int i = 0; i < perm.size(); ++i) {
+        if (perm[i] != i) {
+          return false;
+        }
+      }
+      return true;
+    };
+    if (!(*instr)->attrs.count("axis")) {
+      return false;
+    }
+    auto perm = instr->GetAttrs<ShapeType>("axis");
+    if (is_identity_perm(perm)) {
+      ReplaceWithIdentity(instr, (*instr)->inputs[0]);
+      return true;
+    }
+    auto iter = out2instr.find((*instr)->inputs[0]->id);
+    if (iter == out2instr.end() || iter->second->op_type != "transpose" || !iter->second->attrs.count("axis")) {
+      return false;
+    }
+    auto inner_perm = iter->second.GetAttrs<ShapeType>("axis");
+    if (inner_perm.size() != perm.size()) {
+      return false;
+    }
+    // the i-th dimension of the output is the inner_perm[perm[i]]-th dimension of the origin input
+    ShapeType fused_perm(perm.size());
+    for (int i = 0; i < perm.size(); ++i) {
+      fused_perm[i] = inner_perm[perm[i]];
+    }
+    if (!is_identity_perm(fused_perm)) {
+      return false;
+    }
+    ReplaceWithIdentity(instr, iter->second->inputs[0]);
+    return true;
+  }
+
+  bool SimplifyReduce(Instruction* instr) const {
+    const auto& x   = (*instr)->inputs[0];
+    const auto& out = (*instr)->outputs[0];
+    if (!(*instr)->attrs.count("dim")) {
+      return false;
+    }
+    auto dim = instr->GetAttrs<ShapeType>("dim");
+    // reducing no axis means reducing all the axes
+    if (dim.empty()) {
+      for (int i = 0; i < x->shape.size(); ++i) {
+        dim.push_back(i);
+      }
+    }
+    for (int axis : dim) {
+      if (axis < 0) {
+        axis += x->shape.size();
+      }
+      if (axis < 0 || axis >= x->shape.size() || x->shape[axis] != 1) {
+        return false;
+      }
+    }
+    if (x->type != out->type) {
+      return false;
+    }
+    if (x->shape == out->shape) {
+      ReplaceWithIdentity(instr, x);
+    } else {
+      (*instr)->op_type = "reshape";
+      (*instr)->attrs.clear();
+      (*instr)->attrs_ordered.clear();
+      instr->SetAttr<ShapeType>("shape", out->shape);
+    }
+    return true;
+  }
+
+  // the value of a variable filled by a constant, which may be broadcasted
+  static bool GetConstantValue(const OutputToOpMap& out2instr, const Variable& var, float* value) {
+    auto iter = out2instr.find(var->id);
+    if (iter != out2instr.end() && iter->second->op_type == "broadcast_to") {
+      iter = out2instr.find(iter->second->inputs[0]->id);
+    }
+    if (iter == out2instr.end() || iter->second->op_type != "fill_constant") {
+      return false;
+    }
+    auto value_it = iter->second->attrs.find("value");
+    if (value_it == iter->second->attrs.end() || !absl::holds_alternative<float>(value_it->second)) {
+      return false;
+    }
+    *value = absl::get<float>(value_it->second);
+    return true;
+  }
+
+  // the attribute of an instruction, or the default value of the op if the attribute is not set
+  template <typename T>
+  static T GetAttrOr(const Instruction& instr, const std::string& key, const T& default_value) {
+    return instr->attrs.count(key) ? instr.GetAttrs<T>(key) : default_value;
+  }
+
+  // whether the type `to` holds every value of the type `from`
+  static bool IsLosslessCast(const common::Type& from, const common::Type& to) {
+    if (from.is_bool()) {
+      return true;
+    } else if (from.is_float()) {
+      return to.is_float() && to.bits() >= from.bits();
+    } else if (from.is_int() || from.is_uint()) {
+      if (to.is_float()) {
+        // the significand of float16, float32 and float64 has 11, 24 and 53 bits
+        int significand_bits = to.bits() == 16 ? 11 : (to.bits() == 32 ? 24 : 53);
+        return from.bits() <= significand_bits;
+      }
+      bool same_sign = (from.is_int() && to.is_int()) || (from.is_uint() && to.is_uint());
+      return (same_sign && to.bits() >= from.bits()) || (from.is_uint() && to.is_int() && to.bits() > from.bits());
+    }
+    return false;
+  }
+
+  static void ReplaceWithIdentity(Instruction* instr, const Variable& x) {
+    (*instr)->op_type = "identity";
+    (*instr)->inputs  = {x};
+    (*instr)->attrs.clear();
+    (*instr)->attrs_ordered.clear();
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(AlgebraicSimplification) {
+  CINN_REGISTER_PROGRAM_PASS(AlgebraicSimplification, ::cinn::frontend::pass::AlgebraicSimplificationPass);
+
+  return true;
+}
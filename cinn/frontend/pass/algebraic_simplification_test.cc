@@ -0,0 +1,167 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/pass/test_helper.h"
+
+namespace cinn::frontend {
+
+TEST(AlgebraicSimplification, add_zero_and_multiply_one) {
+  NetBuilder builder("net_builder");
+  auto x    = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto zero = builder.FillConstant<float>({32, 16}, 0.0f, "zero");
+  auto one  = builder.FillConstant<float>({32, 16}, 1.0f, "one");
+  auto add  = builder.Add(x, zero);
+  auto mul  = builder.Multiply(one, add);
+  auto relu = builder.Relu(mul);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 4);
+}
+
+TEST(AlgebraicSimplification, subtract_from_zero) {
+  // 0 - x is not x, so only x - 0 is simplified.
+  NetBuilder builder("net_builder");
+  auto x     = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto zero  = builder.FillConstant<float>({32, 16}, 0.0f, "zero");
+  auto sub_1 = builder.Subtract(zero, x);
+  auto sub_2 = builder.Subtract(sub_1, zero);
+  auto relu  = builder.Relu(sub_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(AlgebraicSimplification, broadcast_scalar) {
+  NetBuilder builder("net_builder");
+  auto x         = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto y         = builder.CreateInput(Float(32), {1}, "y");
+  auto broadcast = builder.BroadcastTo(y, {32, 16});
+  auto add       = builder.Add(x, broadcast);
+  auto relu      = builder.Relu(add);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data(), y.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(AlgebraicSimplification, scale_chain) {
+  // 0.5 * (2 * x + 1) - 0.5 = x
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto scale_1 = builder.Scale(x, 2.0f, 1.0f);
+  auto scale_2 = builder.Scale(scale_1, 0.5f, -1.0f, false);
+  auto scale_3 = builder.Scale(scale_2, 3.0f, 2.0f);
+  auto scale_4 = builder.Scale(scale_3, 0.5f, 1.0f);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {scale_4->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 3);
+}
+
+TEST(AlgebraicSimplification, scale_without_bias_attrs) {
+  // the bias and bias_after_scale of scale are optional, which default to 0 and true
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto scale_1 = builder.CustomInstr("scale", {x}, {{"scale", 2.0f}}).front();
+  auto scale_2 = builder.CustomInstr("scale", {scale_1}, {{"scale", 0.5f}}).front();
+  auto relu    = builder.Relu(scale_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 2);
+}
+
+TEST(AlgebraicSimplification, cast_chain) {
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto cast_1 = builder.Cast(x, "float64");
+  auto cast_2 = builder.Cast(cast_1, "float32");
+  auto relu   = builder.Relu(cast_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 2);
+}
+
+TEST(AlgebraicSimplification, lossy_cast_chain) {
+  // casting to int32 truncates x, so the casts are kept.
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto cast_1 = builder.Cast(x, "int32");
+  auto cast_2 = builder.Cast(cast_1, "float32");
+  auto relu   = builder.Relu(cast_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 0);
+}
+
+TEST(AlgebraicSimplification, reshape_and_transpose_chain) {
+  NetBuilder builder("net_builder");
+  auto x           = builder.CreateInput(Float(32), {4, 8, 16}, "x");
+  auto reshape_1   = builder.Reshape(x, {32, 16});
+  auto reshape_2   = builder.Reshape(reshape_1, {4, 128});
+  auto transpose_1 = builder.Transpose(x, {1, 2, 0});
+  auto transpose_2 = builder.Transpose(transpose_1, {2, 0, 1});
+  auto add         = builder.Add(transpose_2, x);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {reshape_2->id, add->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 3);
+}
+
+TEST(AlgebraicSimplification, reduce_unit_axis) {
+  NetBuilder builder("net_builder");
+  auto x            = builder.CreateInput(Float(32), {32, 1, 16}, "x");
+  auto reduce_sum_1 = builder.ReduceSum(x, {1}, true);
+  auto reduce_sum_2 = builder.ReduceSum(reduce_sum_1, {1}, false);
+  auto relu         = builder.Relu(reduce_sum_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id};
+  std::vector<std::string> program_passes = {"AlgebraicSimplification", "RemoveIdentity", "DeadCodeEliminate"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+}  // namespace cinn::frontend
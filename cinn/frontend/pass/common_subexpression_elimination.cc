@@ -0,0 +1,149 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/utils/string.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// CommonSubexpressionEliminationPass merges the instructions computing the same outputs, which have the same op
+// type, attributes and input variables. The outputs of a removed instruction are replaced by the ones of the first
+// instruction in all the following instructions. An instruction whose outputs are fetched is kept.
+//
+//            <x>                         <x>
+//           /   \                         |
+//     cast       cast                   cast
+//      |           |         =>           | <cast_1>
+//  <cast_1>     <cast_2>                 / \
+//      |           |                relu   scale
+//    relu        scale
+class CommonSubexpressionEliminationPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    // the variables replaced by the outputs of the kept instructions
+    std::unordered_map<std::string, Variable> origin2new;
+    // the kept instructions with the same hash key
+    std::unordered_map<std::string, std::vector<int>> key2instrs;
+    std::unordered_set<int> remove_idxs;
+
+    for (int i = 0; i < program->size(); ++i) {
+      auto& instr = (*program)[i];
+      for (auto& input : instr->inputs) {
+        auto iter = origin2new.find(input->id);
+        if (iter != origin2new.end()) {
+          input = iter->second;
+        }
+      }
+      if (!CanEliminate(instr)) {
+        continue;
+      }
+
+      auto& candidates = key2instrs[HashKey(instr)];
+      auto iter        = std::find_if(
+          candidates.begin(), candidates.end(), [&](int idx) { return IsSame((*program)[idx], instr); });
+      bool is_fetched  = std::any_of(
+          instr->outputs.begin(), instr->outputs.end(), [&](const Variable& var) { return fetch_ids.count(var->id); });
+      if (iter == candidates.end() || is_fetched) {
+        candidates.push_back(i);
+        continue;
+      }
+
+      auto& kept_instr = (*program)[*iter];
+      VLOG(3) << "Remove the " << i << "-th instruction " << instr << " same as " << kept_instr;
+      for (size_t j = 0; j < instr->outputs.size(); ++j) {
+        origin2new.emplace(instr->outputs[j]->id, kept_instr->outputs[j]);
+      }
+      remove_idxs.insert(i);
+    }
+
+    VLOG(3) << "Total remove " << remove_idxs.size() << " instructions.";
+    if (remove_idxs.empty()) {
+      return;
+    }
+    NetBuilder builder("common_subexpression_elimination_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (int i = 0; i < program->size(); ++i) {
+      if (!remove_idxs.count(i)) {
+        builder.AppendInstruction((*program)[i]);
+      }
+    }
+    *program = builder.Build();
+  }
+
+ private:
+  static bool CanEliminate(const Instruction& instr) {
+    // the ops with side effects or randomness compute different results each time
+    static const std::unordered_set<std::string> nondeterministic_ops = {
+        "custom_call", "uniform_random", "gaussian_random", "randint"};
+    return !instr->outputs.empty() && !nondeterministic_ops.count(instr->op_type);
+  }
+
+  // the op type, input variables and attribute names, which is independent of the order of attributes
+  static std::string HashKey(const Instruction& instr) {
+    std::vector<std::string> input_names, attr_names;
+    for (auto& input : instr->inputs) {
+      input_names.push_back(input->id);
+    }
+    for (auto& attr : instr->attrs) {
+      attr_names.push_back(attr.first);
+    }
+    std::sort(attr_names.begin(), attr_names.end());
+    return instr->op_type + "(" + utils::Join(input_names, ",") + ";" + utils::Join(attr_names, ",") + ")";
+  }
+
+  static bool IsSame(const Instruction& a, const Instruction& b) {
+    if (a->op_type != b->op_type || a->inputs.size() != b->inputs.size() ||
+        a->outputs.size() != b->outputs.size() || a->attrs != b->attrs) {
+      return false;
+    }
+    for (size_t i = 0; i < a->inputs.size(); ++i) {
+      if (a->inputs[i]->id != b->inputs[i]->id) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < a->outputs.size(); ++i) {
+      if (a->outputs[i]->type != b->outputs[i]->type || a->outputs[i]->shape != b->outputs[i]->shape) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(CommonSubexpressionElimination) {
+  CINN_REGISTER_PROGRAM_PASS(CommonSubexpressionElimination, cinn::frontend::pass::CommonSubexpressionEliminationPass);
+
+  return true;
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/pass/test_helper.h"
+
+namespace cinn::frontend {
+
+TEST(CommonSubexpressionElimination, merge_chain) {
+  //               <x>                             <x>
+  //             /     \                            |
+  //     transpose     transpose                transpose
+  //         |             |                        |
+  //       scale         scale          =>        scale
+  //         |             |                      /   \
+  //       relu         reduce_sum             relu  reduce_sum
+  NetBuilder builder("net_builder");
+  auto x           = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto transpose_1 = builder.Transpose(x, {1, 0});
+  auto transpose_2 = builder.Transpose(x, {1, 0});
+  auto scale_1     = builder.Scale(transpose_1, 2.0f, 1.0f);
+  auto scale_2     = builder.Scale(transpose_2, 2.0f, 1.0f);
+  auto relu        = builder.Relu(scale_1);
+  auto reduce_sum  = builder.ReduceSum(scale_2, {0});
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {relu->id, reduce_sum->id};
+  std::vector<std::string> program_passes = {"CommonSubexpressionElimination"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 2);
+}
+
+TEST(CommonSubexpressionElimination, different_attrs) {
+  NetBuilder builder("net_builder");
+  auto x          = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto scale_1    = builder.Scale(x, 2.0f, 1.0f);
+  auto scale_2    = builder.Scale(x, 2.0f, 0.0f);
+  auto scale_3    = builder.Scale(x, 2.0f, 1.0f);
+  auto add_1      = builder.Add(scale_1, scale_2);
+  auto add_2      = builder.Add(add_1, scale_3);
+  auto reduce_sum = builder.ReduceSum(add_2, {1});
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {reduce_sum->id};
+  std::vector<std::string> program_passes = {"CommonSubexpressionElimination"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(CommonSubexpressionElimination, cannot_remove_fetch) {
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto cast_1 = builder.Cast(x, "float32");
+  auto cast_2 = builder.Cast(x, "float32");
+  auto relu_1 = builder.Relu(cast_1);
+  auto relu_2 = builder.Relu(cast_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names    = {x.id().data()};
+  std::vector<std::string> output_names   = {cast_2->id, relu_1->id, relu_2->id};
+  std::vector<std::string> program_passes = {"CommonSubexpressionElimination"};
+  int num_removed_ops                     = tester.RunAndCheck(builder, program_passes, input_names, output_names);
+  // the fetched cast_2 is kept, and the relu of cast_2 is not the same as the relu of cast_1 then
+  ASSERT_EQ(num_removed_ops, 0);
+}
+
+}  // namespace cinn::frontend
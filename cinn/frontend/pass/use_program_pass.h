@@ -25,3 +25,5 @@ CINN_USE_REGISTER(GemmRewriter)
 CINN_USE_REGISTER(TransposeFoldingOutput)
 CINN_USE_REGISTER(ReshapeRewriter)
 CINN_USE_REGISTER(FillConstantFolding)
+CINN_USE_REGISTER(CommonSubexpressionElimination)
+CINN_USE_REGISTER(AlgebraicSimplification)
@@ -36,39 +36,56 @@ struct Buffer final {
   explicit Buffer(const common::Target& target) { SetTarget(target); }
   ~Buffer() { Free(); }
   //! Resize the memory hold by this buffer *exactlly* to \p size.
-  void Resize(uint32_t size);
-  void Resize(uint32_t alignment, uint32_t size);
+  void Resize(size_t size);
+  void Resize(uint32_t alignment, size_t size);
 
   //! Lazily resize the memory.
-  void ResizeLazy(uint32_t size);
-  void ResizeLazy(uint32_t alignment, uint32_t size);
+  void ResizeLazy(size_t size);
+  void ResizeLazy(uint32_t alignment, size_t size);
 
   //! Resize the memory to \p size in target \p target.
-  void Resize(uint32_t size, const common::Target& target);
-  void Resize(uint32_t alignment, uint32_t size, const common::Target& target);
+  void Resize(size_t size, const common::Target& target);
+  void Resize(uint32_t alignment, size_t size, const common::Target& target);
 
   //! Lazily resize the memory to \p size in target \p target.
-  void ResizeLazy(uint32_t size, const common::Target& target);
-  void ResizeLazy(uint32_t alignment, uint32_t size, const common::Target& target);
+  void ResizeLazy(size_t size, const common::Target& target);
+  void ResizeLazy(uint32_t alignment, size_t size, const common::Target& target);
 
   void SetTarget(const common::Target& target);
 
+  const common::Target& target() const { return target_; }
+
+  //! Bind a block of \p size bytes which is not owned by this buffer, \p holder keeps the block alive if given, such as
+  //! the Buffer of an arena or a mapped file.
+  void BindExternalMemory(void* memory, size_t size, std::shared_ptr<const void> holder = nullptr);
+
+  //! Whether the memory is bound by BindExternalMemory rather than allocated by this buffer.
+  bool is_external_memory() const { return is_external_memory_; }
+
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
   //! Free all the memory owned by this buffer.
   void Free() {
     if (!data_.memory) return;
+    if (is_external_memory_) {
+      // only detach the external memory, it is released by its owner
+      data_.memory        = nullptr;
+      size_               = 0;
+      is_external_memory_ = false;
+      external_holder_.reset();
+      return;
+    }
     memory_mng_cache_->free(data_.memory);
   }
 
  private:
-  inline void* Malloc(uint32_t size) CINN_RESULT_SHOULD_USE {
+  inline void* Malloc(size_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
     return memory_mng_cache_->malloc(size);
   }
 
-  inline void* AlignedAlloc(uint32_t alignment, uint32_t size) CINN_RESULT_SHOULD_USE {
+  inline void* AlignedAlloc(uint32_t alignment, size_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
     return memory_mng_cache_->aligned_alloc(alignment, size);
   }
@@ -80,10 +97,16 @@ struct Buffer final {
   common::Target target_;
 
   //! Number of bytes of this buffer.
-  uint32_t size_{};
+  size_t size_{};
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Whether the memory is external and should not be freed by this buffer.
+  bool is_external_memory_{false};
+
+  //! Keep the owner of the external memory alive.
+  std::shared_ptr<const void> external_holder_;
 };
 
 }  // namespace framework
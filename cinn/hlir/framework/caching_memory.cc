@@ -0,0 +1,262 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/caching_memory.h"
+
+#include <glog/logging.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <unordered_map>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+constexpr int kMinShift                = 6;  // 64 bytes
+constexpr int kMaxShift                = 36;
+constexpr int kSubClassNum             = 4;
+constexpr int kSizeClassNum            = 1 + (kMaxShift - kMinShift) * kSubClassNum;
+constexpr int kAlignLevelNum           = 7;  // 64 bytes to 4KB
+constexpr size_t kMinAlignment         = 1UL << kMinShift;
+constexpr size_t kMaxCachedAlignment   = kMinAlignment << (kAlignLevelNum - 1);
+constexpr size_t kHugePageSize         = 2UL << 20;
+constexpr size_t kMaxThreadCachedSize  = 256UL << 10;
+constexpr int kMaxThreadCachedBlockNum = 8;
+
+// The header lies in front of each block returned to users.
+struct BlockHeader {
+  void* raw;
+  size_t size;
+  // index of the free list, -1 means the block is not cached
+  int list_index;
+};
+static_assert(sizeof(BlockHeader) <= kMinAlignment, "BlockHeader should fit in the minimum alignment");
+
+BlockHeader* GetHeader(void* data) {
+  return reinterpret_cast<BlockHeader*>(reinterpret_cast<uint8_t*>(data) - sizeof(BlockHeader));
+}
+
+int HighestBit(size_t x) { return 63 - __builtin_clzl(x); }
+
+// Round up the size to its size class, and get the class index, -1 if it is too large to be cached.
+size_t RoundUpSize(size_t nbytes, int* size_class) {
+  if (nbytes <= kMinAlignment) {
+    *size_class = 0;
+    return kMinAlignment;
+  }
+  int shift = HighestBit(nbytes - 1);  // 2^shift < nbytes <= 2^(shift+1)
+  if (shift >= kMaxShift) {
+    *size_class = -1;
+    return (nbytes + kMinAlignment - 1) / kMinAlignment * kMinAlignment;
+  }
+  size_t step    = (1UL << shift) / kSubClassNum;
+  size_t rounded = (nbytes + step - 1) / step * step;
+  *size_class    = 1 + (shift - kMinShift) * kSubClassNum + static_cast<int>(((rounded - (1UL << shift)) / step) - 1);
+  return rounded;
+}
+
+void ReleaseToSystem(void* data) { ::free(GetHeader(data)->raw); }
+
+// Whether the thread-local caches of the calling thread are alive. It is trivially destructible, so it can still be
+// read after the thread-local caches are destroyed at thread exit, e.g. when a static object frees its memory after
+// the main thread's thread-local objects are gone.
+thread_local bool thread_caches_alive = true;
+
+}  // namespace
+
+std::string MemoryStats::DebugString() const {
+  std::stringstream ss;
+  ss << "bytes_in_use: " << bytes_in_use << ", peak_bytes_in_use: " << peak_bytes_in_use
+     << ", cached_bytes: " << cached_bytes << ", num_allocs: " << num_allocs << ", num_cache_hits: " << num_cache_hits
+     << ", hit_rate: " << hit_rate();
+  return ss.str();
+}
+
+struct X86CachingMemoryMng::ThreadCache {
+  std::vector<std::vector<void*>> free_lists;
+
+  ThreadCache() : free_lists(kAlignLevelNum * kSizeClassNum) {}
+
+  ~ThreadCache() {
+    for (auto& free_list : free_lists) {
+      std::for_each(free_list.begin(), free_list.end(), ReleaseToSystem);
+    }
+  }
+};
+
+X86CachingMemoryMng::X86CachingMemoryMng(size_t max_cached_bytes, bool use_huge_page)
+    : id_([] {
+        static std::atomic<uint64_t> next_id{0};
+        return ++next_id;
+      }()),
+      max_cached_bytes_(max_cached_bytes),
+      use_huge_page_(use_huge_page),
+      global_free_lists_(kAlignLevelNum * kSizeClassNum) {}
+
+X86CachingMemoryMng::~X86CachingMemoryMng() {
+  // the thread-local caches are released when their threads exit
+  for (auto& free_list : global_free_lists_) {
+    std::for_each(free_list.begin(), free_list.end(), ReleaseToSystem);
+  }
+}
+
+X86CachingMemoryMng::ThreadCache* X86CachingMemoryMng::GetThreadCache() {
+  // blocks left in the cache of an exited thread are released to system
+  struct ThreadCaches {
+    std::unordered_map<uint64_t, ThreadCache> caches;
+    ~ThreadCaches() { thread_caches_alive = false; }
+  };
+  if (!thread_caches_alive) {
+    return nullptr;
+  }
+  thread_local ThreadCaches thread_caches;
+  return &thread_caches.caches[id_];
+}
+
+void X86CachingMemoryMng::RecordAlloc(size_t size, bool cache_hit) {
+  ++num_allocs_;
+  if (cache_hit) {
+    ++num_cache_hits_;
+  }
+  size_t in_use = bytes_in_use_.fetch_add(size) + size;
+  size_t peak   = peak_bytes_in_use_.load();
+  while (in_use > peak && !peak_bytes_in_use_.compare_exchange_weak(peak, in_use)) {
+  }
+}
+
+void* X86CachingMemoryMng::malloc(size_t nbytes) { return Allocate(kMinAlignment, nbytes); }
+
+void* X86CachingMemoryMng::aligned_alloc(size_t alignment, size_t nbytes) { return Allocate(alignment, nbytes); }
+
+void* X86CachingMemoryMng::Allocate(size_t alignment, size_t nbytes) {
+  CHECK_EQ(alignment & (alignment - 1), 0) << "The alignment should be a power of 2, but got " << alignment;
+  alignment = std::max(alignment, kMinAlignment);
+
+  int size_class = -1;
+  size_t size    = RoundUpSize(nbytes, &size_class);
+  int list_index = -1;
+  if (size_class >= 0 && alignment <= kMaxCachedAlignment) {
+    list_index = (HighestBit(alignment) - kMinShift) * kSizeClassNum + size_class;
+  }
+
+  // try to reuse a cached block
+  if (list_index >= 0) {
+    auto* thread_cache = size <= kMaxThreadCachedSize ? GetThreadCache() : nullptr;
+    if (thread_cache) {
+      auto& free_list = thread_cache->free_lists[list_index];
+      if (!free_list.empty()) {
+        void* data = free_list.back();
+        free_list.pop_back();
+        RecordAlloc(size, true);
+        return data;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto& free_list = global_free_lists_[list_index];
+    if (!free_list.empty()) {
+      void* data = free_list.back();
+      free_list.pop_back();
+      cached_bytes_ -= size;
+      RecordAlloc(size, true);
+      return data;
+    }
+  }
+
+  // allocate a new block from system, the header is put in front of the user data
+  bool huge_page   = use_huge_page_ && size >= kHugePageSize;
+  size_t raw_align = huge_page ? std::max(alignment, kHugePageSize) : alignment;
+  size_t raw_size  = alignment + size;
+  if (huge_page) {
+    raw_size = (raw_size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+  void* raw = nullptr;
+  if (posix_memalign(&raw, raw_align, raw_size) != 0) {
+    LOG(FATAL) << "Failed to allocate " << raw_size << " bytes with alignment " << raw_align;
+  }
+#ifdef MADV_HUGEPAGE
+  if (huge_page) {
+    madvise(raw, raw_size, MADV_HUGEPAGE);
+  }
+#endif
+  void* data          = reinterpret_cast<uint8_t*>(raw) + alignment;
+  auto* header        = GetHeader(data);
+  header->raw         = raw;
+  header->size        = size;
+  header->list_index  = list_index;
+  RecordAlloc(size, false);
+  return data;
+}
+
+void X86CachingMemoryMng::free(void* data) {
+  if (!data) return;
+  auto* header = GetHeader(data);
+  bytes_in_use_ -= header->size;
+  if (header->list_index < 0) {
+    ReleaseToSystem(data);
+    return;
+  }
+
+  // fall back to the global pool once the cache of the calling thread is destroyed
+  auto* thread_cache = header->size <= kMaxThreadCachedSize ? GetThreadCache() : nullptr;
+  if (thread_cache) {
+    auto& free_list = thread_cache->free_lists[header->list_index];
+    if (free_list.size() < kMaxThreadCachedBlockNum) {
+      free_list.push_back(data);
+      return;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (cached_bytes_ + header->size <= max_cached_bytes_) {
+      global_free_lists_[header->list_index].push_back(data);
+      cached_bytes_ += header->size;
+      return;
+    }
+  }
+  ReleaseToSystem(data);
+}
+
+MemoryStats X86CachingMemoryMng::GetStats() const {
+  MemoryStats stats;
+  stats.bytes_in_use      = bytes_in_use_;
+  stats.peak_bytes_in_use = peak_bytes_in_use_;
+  stats.cached_bytes      = cached_bytes_;
+  stats.num_allocs        = num_allocs_;
+  stats.num_cache_hits    = num_cache_hits_;
+  return stats;
+}
+
+void X86CachingMemoryMng::ReleaseCachedBlocks() {
+  if (auto* thread_cache = GetThreadCache()) {
+    for (auto& free_list : thread_cache->free_lists) {
+      std::for_each(free_list.begin(), free_list.end(), ReleaseToSystem);
+      free_list.clear();
+    }
+  }
+  std::lock_guard<std::mutex> lock(mtx_);
+  for (auto& free_list : global_free_lists_) {
+    std::for_each(free_list.begin(), free_list.end(), ReleaseToSystem);
+    free_list.clear();
+  }
+  cached_bytes_ = 0;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
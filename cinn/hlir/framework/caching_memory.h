@@ -0,0 +1,94 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/memory.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+struct MemoryStats {
+  // bytes of the blocks held by users
+  size_t bytes_in_use{};
+  // the peak of bytes_in_use
+  size_t peak_bytes_in_use{};
+  // bytes of the free blocks kept in the global pool, excluding thread-local caches
+  size_t cached_bytes{};
+  // number of malloc/aligned_alloc calls
+  uint64_t num_allocs{};
+  // number of allocations served from the cached blocks
+  uint64_t num_cache_hits{};
+
+  double hit_rate() const { return num_allocs ? static_cast<double>(num_cache_hits) / num_allocs : 0.0; }
+
+  std::string DebugString() const;
+};
+
+/**
+ * X86CachingMemoryMng is a MemoryInterface caching freed blocks by size class for reuse, so that repeated
+ * allocations of the same size do not reach the system allocator. Sizes are rounded up to one of four
+ * classes between two adjacent powers of two. Small blocks are cached in thread-local free lists and large
+ * blocks in a global pool bounded by `max_cached_bytes`. Every block is at least 64-byte aligned, and blocks
+ * no smaller than 2MB are backed by transparent huge pages if `use_huge_page` is set.
+ */
+class X86CachingMemoryMng : public MemoryInterface {
+ public:
+  explicit X86CachingMemoryMng(size_t max_cached_bytes = 1UL << 30, bool use_huge_page = false);
+  ~X86CachingMemoryMng();
+
+  void* malloc(size_t nbytes) override;
+  void free(void* data) override;
+  void* aligned_alloc(size_t alignment, size_t nbytes) override;
+
+  MemoryStats GetStats() const;
+
+  // release all blocks in the global pool and the cache of the calling thread to system
+  void ReleaseCachedBlocks();
+
+ private:
+  struct ThreadCache;
+  ThreadCache* GetThreadCache();
+  void* Allocate(size_t alignment, size_t nbytes);
+  void RecordAlloc(size_t size, bool cache_hit);
+
+  // unique id to match the thread-local caches of this instance
+  const uint64_t id_;
+  const size_t max_cached_bytes_;
+  const bool use_huge_page_;
+
+  std::mutex mtx_;
+  // the global free lists indexed by (alignment level, size class)
+  std::vector<std::vector<void*>> global_free_lists_;
+
+  std::atomic<size_t> bytes_in_use_{0};
+  std::atomic<size_t> peak_bytes_in_use_{0};
+  std::atomic<size_t> cached_bytes_{0};
+  std::atomic<uint64_t> num_allocs_{0};
+  std::atomic<uint64_t> num_cache_hits_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(X86CachingMemoryMng);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,97 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/caching_memory.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(X86CachingMemoryMng, Reuse) {
+  X86CachingMemoryMng memory_mng;
+  for (int i = 0; i < 3; ++i) {
+    void* small = memory_mng.malloc(100);
+    void* large = memory_mng.aligned_alloc(1024, 4 << 20);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(small) % 64, 0UL);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(large) % 1024, 0UL);
+    std::memset(small, 0, 100);
+    std::memset(large, 0, 4 << 20);
+    memory_mng.free(small);
+    memory_mng.free(large);
+  }
+
+  auto stats = memory_mng.GetStats();
+  LOG(INFO) << stats.DebugString();
+  ASSERT_EQ(stats.num_allocs, 6UL);
+  // only the first round reaches the system allocator
+  ASSERT_EQ(stats.num_cache_hits, 4UL);
+  ASSERT_EQ(stats.bytes_in_use, 0UL);
+  ASSERT_GE(stats.peak_bytes_in_use, (4UL << 20) + 100);
+  ASSERT_EQ(stats.cached_bytes, 4UL << 20);
+
+  memory_mng.ReleaseCachedBlocks();
+  ASSERT_EQ(memory_mng.GetStats().cached_bytes, 0UL);
+}
+
+TEST(X86CachingMemoryMng, MultiThreads) {
+  X86CachingMemoryMng memory_mng(1 << 20, true);
+  auto worker = [&memory_mng]() {
+    for (int i = 0; i < 100; ++i) {
+      void* data = memory_mng.malloc(64 * (i % 10 + 1));
+      memory_mng.free(data);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = memory_mng.GetStats();
+  ASSERT_EQ(stats.num_allocs, 400UL);
+  ASSERT_EQ(stats.bytes_in_use, 0UL);
+  ASSERT_GT(stats.hit_rate(), 0.5);
+}
+
+TEST(X86CachingMemoryMng, FreeAfterThreadCacheDestroyed) {
+  X86CachingMemoryMng memory_mng;
+  std::thread thread([&memory_mng]() {
+    // the holder is constructed before the thread-local caches, so it is destroyed after them
+    struct Holder {
+      X86CachingMemoryMng* memory_mng;
+      void* data;
+      ~Holder() { memory_mng->free(data); }
+    };
+    thread_local Holder holder{&memory_mng, nullptr};
+    holder.data = memory_mng.malloc(1024);
+  });
+  thread.join();
+
+  // the block goes to the global pool rather than the destroyed thread-local cache
+  auto stats = memory_mng.GetStats();
+  ASSERT_EQ(stats.bytes_in_use, 0UL);
+  ASSERT_EQ(stats.cached_bytes, 1024UL);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
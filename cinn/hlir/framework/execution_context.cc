@@ -0,0 +1,63 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/execution_context.h"
+
+#include <absl/container/flat_hash_map.h>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+ExecutionContext::ExecutionContext(const Scope& shared_scope,
+                                   const std::vector<Instruction*>& instrs,
+                                   const std::unordered_set<std::string>& private_vars,
+                                   const Target& default_target)
+    : scope_(std::make_shared<Scope>()), private_vars_(private_vars) {
+  // the variables sharing a buffer in the shared scope, such as the ones aliased by
+  // reshape, still share one private buffer in this context
+  absl::flat_hash_map<Buffer*, std::shared_ptr<Buffer>> private_buffers;
+  for (auto& name_view : shared_scope.var_names()) {
+    std::string name(name_view.data(), name_view.size());
+    auto src_tensor = shared_scope.GetTensor(name);
+    auto* var       = scope_->Var<Tensor>(name);
+    if (!private_vars_.count(name)) {
+      *var = src_tensor;
+      continue;
+    }
+
+    auto& tensor = absl::get<Tensor>(*var);
+    tensor->Resize(src_tensor->shape());
+    tensor->set_type(src_tensor->type());
+    auto src_buffer = src_tensor->get_buffer();
+    auto it         = private_buffers.find(src_buffer.get());
+    if (it != private_buffers.end()) {
+      tensor->set_buffer(it->second);
+      continue;
+    }
+    const auto& target = src_buffer->target().arch == Target::Arch::Unk ? default_target : src_buffer->target();
+    tensor->mutable_data(target, tensor->type());
+    private_buffers.emplace(src_buffer.get(), tensor->get_buffer());
+    VLOG(4) << "Variable [" << name << "] owns a private buffer of " << tensor->shape().numel() << " elements";
+  }
+
+  instr_args_.reserve(instrs.size());
+  for (auto* instr : instrs) {
+    instr_args_.emplace_back(instr->BuildArgs(*scope_));
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
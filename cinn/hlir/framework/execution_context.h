@@ -0,0 +1,79 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/runtime/cpu/thread_pool.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * ExecutionContext holds the state of one request to a Program. It shares the variables no instruction writes, such
+ * as weights and constants, with the scope of the Program, and owns private tensors for the others together with the
+ * prepared arguments of every instruction. Different contexts of one Program can be executed concurrently.
+ */
+class ExecutionContext {
+ public:
+  /**
+   * Constructor.
+   * @param shared_scope The scope of the Program.
+   * @param instrs The instructions of the Program.
+   * @param private_vars The variables to own private tensors, the others are shared with \p shared_scope.
+   * @param default_target The target to allocate a private tensor on if its shared one has not been allocated yet.
+   */
+  ExecutionContext(const Scope& shared_scope,
+                   const std::vector<Instruction*>& instrs,
+                   const std::unordered_set<std::string>& private_vars,
+                   const Target& default_target);
+
+  //! Get a variable of this context, such as an input to feed or an output to fetch.
+  Tensor GetTensor(const std::string& name) const { return scope_->GetTensor(name); }
+
+  //! Whether the variable is owned by this context rather than shared.
+  bool IsPrivate(const std::string& name) const { return private_vars_.count(name); }
+
+  const std::shared_ptr<Scope>& scope() const { return scope_; }
+
+  //! Get the arguments of the \p index-th instruction.
+  std::vector<std::vector<cinn_pod_value_t>>* GetInstructionArgs(int index) { return &instr_args_.at(index); }
+
+  size_t instruction_num() const { return instr_args_.size(); }
+
+  //! Execute the requests of this context within a slice of the cores rather than the one of the Program.
+  void SetThreadBudget(const std::shared_ptr<runtime::cpu::ThreadBudget>& budget) { thread_budget_ = budget; }
+  const std::shared_ptr<runtime::cpu::ThreadBudget>& thread_budget() const { return thread_budget_; }
+
+ private:
+  std::shared_ptr<Scope> scope_;
+  std::unordered_set<std::string> private_vars_;
+  std::vector<std::vector<std::vector<cinn_pod_value_t>>> instr_args_;
+  std::shared_ptr<runtime::cpu::ThreadBudget> thread_budget_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ExecutionContext);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
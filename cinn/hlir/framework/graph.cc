@@ -75,6 +75,14 @@ void Graph::Initialize(const frontend::Program& prog,
   this->attrs["inferdtype"] = std::make_shared<absl::any>(dtype_dict);
 }
 
+constexpr int Graph::kSymbolicDim;
+
+const absl::flat_hash_set<std::string>& Graph::GetSymbolicOuterDimVars() const {
+  static const absl::flat_hash_set<std::string> empty_vars;
+  return HasAttr("symbolic_outer_dim_vars") ? GetAttrs<absl::flat_hash_set<std::string>>("symbolic_outer_dim_vars")
+                                            : empty_vars;
+}
+
 void Graph::VisualizeGroupedGraph(const std::unordered_set<std::string>& fetch_var_ids) {
   std::vector<std::vector<Node*>> groups;
   groups.resize(fusion_groups.size());
@@ -14,6 +14,7 @@
 
 #pragma once
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 #include <absl/types/any.h>
 
 #include <atomic>
@@ -165,6 +166,17 @@ class Graph : public cinn::common::Graph {
     return it != attrs.end();
   }
 
+  //! the extent marking the outermost dimension of a program input as symbolic, such as a dynamic batch size
+  static constexpr int kSymbolicDim = -1;
+
+  /**
+   * \brief Get the variables whose outermost dimension is symbolic, which is inferred by the InferShape pass from the
+   * inputs marked by kSymbolicDim. The shapes of these variables in the attribute "infershape" hold a representative
+   * extent at the outermost dimension.
+   * @return the names of the variables, empty if no dimension is symbolic
+   */
+  const absl::flat_hash_set<std::string>& GetSymbolicOuterDimVars() const;
+
   /**
    * \brief Visualize the grouped graph according to fusion_groups.
    */
@@ -16,7 +16,13 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -28,9 +34,15 @@
 #include "cinn/lang/lower.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_ir_schedule);
 DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_int32(cinn_program_executor_threads);
+DECLARE_bool(cinn_self_check_accuracy);
+DECLARE_bool(cinn_share_identical_groups);
+DECLARE_bool(cinn_sync_run);
 
 namespace cinn {
 namespace hlir {
@@ -71,6 +83,8 @@ Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_pt
 }
 
 void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  // the functions and arguments of instructions are changed by their PreRun
+  launch_plan_built_ = false;
   for (auto& ins : prerun_instrs_) {
     ins->Run(name2podargs);
   }
@@ -204,9 +218,349 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
   fclose(f);
 }
 
+namespace {
+
+// Pops the instructions whose predecessors all finished, it blocks the calling
+// thread until an instruction is ready, all instructions were finished or it is aborted.
+class InstructionDispatcher : public utils::JobDispatcher {
+ public:
+  InstructionDispatcher(const std::vector<std::vector<int>>& successors, const std::vector<int>& in_degree)
+      : successors_(successors), in_degree_(in_degree), finished_num_(0) {
+    for (int i = 0; i < in_degree_.size(); ++i) {
+      if (in_degree_[i] == 0) {
+        ready_.push(i);
+      }
+    }
+  }
+
+  int Next() const override {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return aborted_ || !ready_.empty() || finished_num_ == in_degree_.size(); });
+    if (aborted_ || ready_.empty()) {
+      return -1;
+    }
+    int index = ready_.front();
+    ready_.pop();
+    return index;
+  }
+
+  // mark the instruction finished and release its successors
+  void Finish(int index) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      ++finished_num_;
+      for (int succ : successors_[index]) {
+        if (--in_degree_[succ] == 0) {
+          ready_.push(succ);
+        }
+      }
+    }
+    cv_.notify_all();
+  }
+
+  // stop dispatching after an instruction failed, so the executors waiting for its successors return
+  void Abort() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      aborted_ = true;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  const std::vector<std::vector<int>>& successors_;
+  std::vector<int> in_degree_;
+  size_t finished_num_;
+  bool aborted_ = false;
+  mutable std::queue<int> ready_;
+  mutable std::mutex mtx_;
+  mutable std::condition_variable cv_;
+};
+
+// The buffer malloc/free instructions inserted by GraphCompiler::InsertBufferHandlers
+// mutate the buffers of all their arguments, no matter they are listed as inputs or outputs.
+bool IsBufferHandleInstruction(Instruction* instr) {
+  for (auto& fn_name : instr->GetFnNames()) {
+    if (fn_name.find("malloc_buffer_instruction") != std::string::npos ||
+        fn_name.find("free_buffer_instruction") != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+void Program::BuildInstructionDependency() {
+  instr_successors_.assign(instrs_.size(), {});
+  instr_in_degree_.assign(instrs_.size(), 0);
+  parallel_executable_ = true;
+
+  // the last instruction writing a variable and the instructions reading it after that
+  absl::flat_hash_map<std::string, int> last_writer;
+  absl::flat_hash_map<std::string, std::vector<int>> readers_after_write;
+  auto add_edge = [this](int from, int to) {
+    if (from != to) {
+      instr_successors_[from].push_back(to);
+    }
+  };
+
+  for (int idx = 0; idx < instrs_.size(); ++idx) {
+    auto& instr = instrs_[idx];
+    if (instr->target_.arch != Target::Arch::X86) {
+      parallel_executable_ = false;
+    }
+
+    std::vector<std::string> read_vars, write_vars;
+    for (auto& args : instr->GetOutArgs()) {
+      write_vars.insert(write_vars.end(), args.begin(), args.end());
+    }
+    for (auto& args : instr->GetInArgs()) {
+      auto& vars = IsBufferHandleInstruction(instr.get()) ? write_vars : read_vars;
+      vars.insert(vars.end(), args.begin(), args.end());
+    }
+
+    // read after write
+    for (auto& var : read_vars) {
+      if (last_writer.count(var)) {
+        add_edge(last_writer.at(var), idx);
+      }
+      readers_after_write[var].push_back(idx);
+    }
+    // write after read and write after write
+    for (auto& var : write_vars) {
+      if (last_writer.count(var)) {
+        add_edge(last_writer.at(var), idx);
+      }
+      // the memory of a planned variable is reused only after its previous owners dead
+      auto reuse_it = memory_reused_from_.find(var);
+      if (reuse_it != memory_reused_from_.end()) {
+        for (auto& prev_var : reuse_it->second) {
+          if (last_writer.count(prev_var)) {
+            add_edge(last_writer.at(prev_var), idx);
+          }
+          for (int reader : readers_after_write[prev_var]) {
+            add_edge(reader, idx);
+          }
+        }
+      }
+      for (int reader : readers_after_write[var]) {
+        add_edge(reader, idx);
+      }
+      last_writer[var] = idx;
+      readers_after_write[var].clear();
+    }
+  }
+
+  for (auto& succs : instr_successors_) {
+    std::sort(succs.begin(), succs.end());
+    succs.erase(std::unique(succs.begin(), succs.end()), succs.end());
+    for (int succ : succs) {
+      ++instr_in_degree_[succ];
+    }
+  }
+  dependency_built_ = true;
+}
+
+int Program::PrepareParallelExecution(const runtime::cpu::ThreadBudget* budget) {
+  int num_threads = std::min<int>(FLAGS_cinn_program_executor_threads, instrs_.size());
+  if (budget) {
+    num_threads = std::min(num_threads, budget->num_threads());
+  }
+  if (num_threads <= 1) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(dependency_mtx_);
+  if (!dependency_built_) {
+    BuildInstructionDependency();
+  }
+  return parallel_executable_ ? num_threads : 1;
+}
+
+void Program::ExecuteInParallel(const std::function<void(int)>& run_instr,
+                                int num_threads,
+                                runtime::cpu::ThreadBudget* budget) {
+  InstructionDispatcher dispatcher(instr_successors_, instr_in_degree_);
+  // each executor thread is pinned to its own part of the budget and launches its parallel loops within the part,
+  // so the executors and their parallel loops together run on at most budget->num_threads() threads
+  auto* parts = budget ? &budget->Partition(num_threads) : nullptr;
+  // the first error of the executors, which is rethrown on the calling thread once all of them returned
+  std::exception_ptr error;
+  std::mutex error_mtx;
+  auto executor = [&](int slot) {
+    runtime::cpu::ThreadBudgetGuard budget_guard(parts ? (*parts)[slot].get() : nullptr, true);
+    try {
+      for (int index = dispatcher.Next(); index >= 0; index = dispatcher.Next()) {
+        run_instr(index);
+        dispatcher.Finish(index);
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(error_mtx);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      dispatcher.Abort();
+    }
+  };
+  utils::parallel_for(0, num_threads, executor, num_threads);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void Program::BuildLaunchPlan(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  launch_plan_.clear();
+  for (auto& instr : instrs_) {
+    auto kind = instr->launch_kind();
+    if (kind == Instruction::LaunchKind::kNoRun) {
+      continue;
+    }
+    if (kind == Instruction::LaunchKind::kExternal) {
+      launch_plan_.push_back({nullptr, nullptr, 0, kind, instr.get()});
+      continue;
+    }
+    if (!instr->IsArgsCached()) {
+      instr->UpdateArgsCache(name2podargs);
+    }
+    const auto& fn_ptrs = instr->GetFnPtrs();
+    auto& args_cache    = instr->GetArgsCache();
+    for (int idx = 0; idx < fn_ptrs.size(); ++idx) {
+      CHECK(fn_ptrs[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
+      launch_plan_.push_back(
+          {fn_ptrs[idx], args_cache[idx].data(), static_cast<int>(args_cache[idx].size()), kind, instr.get()});
+    }
+  }
+  launch_plan_built_ = true;
+  VLOG(3) << "Build a launch plan of " << launch_plan_.size() << " functions from " << instrs_.size()
+          << " instructions";
+}
+
+void Program::RunLaunchPlan(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
+  auto launch = [&](const LaunchStep& step) {
+    switch (step.kind) {
+      case Instruction::LaunchKind::kHost:
+        reinterpret_cast<lower_func_ptr_t>(step.fn_ptr)(step.args, step.num_args);
+        break;
+      case Instruction::LaunchKind::kDevice:
+        reinterpret_cast<lower_func_ptr_g>(step.fn_ptr)(step.args, step.num_args, stream);
+        break;
+      default:
+        step.instr->Run(name2podargs, false, stream, true);
+    }
+  };
+
+  if (utils::HostEventRecorder::Enabled()) {
+    for (auto& step : launch_plan_) {
+      // external instructions are recorded by their Run
+      if (step.kind == Instruction::LaunchKind::kExternal) {
+        launch(step);
+        continue;
+      }
+      utils::RecordEvent record_run(step.instr->function_name(), GetArgsBytes(step.args, step.num_args));
+      launch(step);
+    }
+  } else {
+    for (auto& step : launch_plan_) {
+      launch(step);
+    }
+  }
+}
+
+void Program::SetSymbolicOuterDimVars(const absl::flat_hash_set<std::string>& symbolic_vars) {
+  std::unordered_set<std::string> written_vars;
+  for (auto& instr : instrs_) {
+    for (auto& args : instr->GetOutArgs()) {
+      written_vars.insert(args.begin(), args.end());
+    }
+  }
+  symbolic_feed_vars_.clear();
+  symbolic_written_vars_.clear();
+  for (auto& name : symbolic_vars) {
+    // skip the variables removed as unused
+    if (!scope_->FindVar(name)) {
+      continue;
+    }
+    if (written_vars.count(name)) {
+      symbolic_written_vars_.push_back(name);
+    } else {
+      symbolic_feed_vars_.push_back(name);
+    }
+  }
+  std::sort(symbolic_feed_vars_.begin(), symbolic_feed_vars_.end());
+  std::sort(symbolic_written_vars_.begin(), symbolic_written_vars_.end());
+  CHECK(symbolic_written_vars_.empty() || !symbolic_feed_vars_.empty())
+      << "The symbolic variables written by instructions can't be resized without a symbolic feed";
+}
+
+absl::flat_hash_set<std::string> Program::GetSymbolicOuterDimVars() const {
+  absl::flat_hash_set<std::string> symbolic_vars(symbolic_feed_vars_.begin(), symbolic_feed_vars_.end());
+  symbolic_vars.insert(symbolic_written_vars_.begin(), symbolic_written_vars_.end());
+  return symbolic_vars;
+}
+
+void Program::ResizeSymbolicVars(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  if (symbolic_written_vars_.empty()) {
+    return;
+  }
+  auto is_fed_by_args = [&](const std::string& name) { return name2podargs && name2podargs->count(name); };
+  int extent          = -1;
+  for (auto& name : symbolic_feed_vars_) {
+    int feed_extent = 0;
+    if (is_fed_by_args(name)) {
+      auto* buffer = cinn_pod_value_to_buffer_p(const_cast<cinn_pod_value_t*>(&name2podargs->at(name)));
+      CHECK_GT(buffer->dimensions, 0) << "The symbolic variable " << name << " can't be a scalar";
+      feed_extent = buffer->dims[0];
+    } else {
+      auto tensor = scope_->GetTensor(name);
+      CHECK(!tensor->shape().data().empty()) << "The symbolic variable " << name << " can't be a scalar";
+      feed_extent = tensor->shape().data()[0];
+    }
+    CHECK(extent == -1 || extent == feed_extent)
+        << "The symbolic variables are fed with different outermost extents " << extent << " and " << feed_extent;
+    extent = feed_extent;
+  }
+  auto target = instrs_.empty() ? common::DefaultHostTarget() : instrs_.front()->target_;
+  for (auto& name : symbolic_written_vars_) {
+    if (is_fed_by_args(name)) {
+      continue;
+    }
+    auto tensor = scope_->GetTensor(name);
+    auto shape  = tensor->shape().data();
+    if (shape[0] == extent) {
+      continue;
+    }
+    shape[0] = extent;
+    // the cinn_buffer_t is kept, so the cached arguments of instructions are still valid
+    tensor->Resize(Shape(shape));
+    if (tensor->buffer()->memory) {
+      tensor->mutable_data(target, tensor->type());
+    }
+  }
+}
+
 void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
-  for (auto& ins : instrs_) {
-    ins->Run(name2podargs, false, stream, use_cache);
+  ResizeSymbolicVars(name2podargs);
+  runtime::cpu::ThreadBudgetGuard budget_guard(thread_budget_.get());
+  int num_threads = PrepareParallelExecution(thread_budget_.get());
+  if (num_threads > 1) {
+    ExecuteInParallel([&](int index) { instrs_[index]->Run(name2podargs, false, stream, use_cache); },
+                      num_threads,
+                      thread_budget_.get());
+  } else if (use_cache && !FLAGS_cinn_self_check_accuracy && !FLAGS_cinn_sync_run) {
+    if (!launch_plan_built_) {
+      BuildLaunchPlan(name2podargs);
+    }
+    RunLaunchPlan(name2podargs, stream);
+  } else {
+    for (auto& ins : instrs_) {
+      ins->Run(name2podargs, false, stream, use_cache);
+    }
+  }
+  // the args cache is rebuilt by the instructions if not use cache
+  if (!use_cache) {
+    launch_plan_built_ = false;
   }
 #ifdef CINN_WITH_CUDA
   VLOG(4) << "-- The value of the used stream: " << stream;
@@ -216,6 +570,44 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
 #endif
 }
 
+std::unique_ptr<ExecutionContext> Program::CreateExecutionContext(const std::vector<std::string>& input_names) const {
+  CHECK(symbolic_written_vars_.empty()) << "The program with symbolic dimension can't be executed by a context yet";
+  std::unordered_set<std::string> private_vars(input_names.begin(), input_names.end());
+  std::vector<Instruction*> instrs;
+  for (auto& instr : instrs_) {
+    CHECK(!IsBufferHandleInstruction(instr.get()))
+        << "The buffers allocated and released by instructions can not be owned by an execution context, "
+           "please build the program without buffer handle instructions";
+    for (auto& args : instr->GetOutArgs()) {
+      private_vars.insert(args.begin(), args.end());
+    }
+    instrs.push_back(instr.get());
+  }
+  auto default_target = instrs_.empty() ? common::DefaultHostTarget() : instrs_.front()->target_;
+  return std::make_unique<ExecutionContext>(*scope_, instrs, private_vars, default_target);
+}
+
+void Program::Execute(ExecutionContext* context, void* stream) {
+  CHECK_EQ(context->instruction_num(), instrs_.size()) << "The context is not created by this program";
+  auto* budget = context->thread_budget() ? context->thread_budget().get() : thread_budget_.get();
+  runtime::cpu::ThreadBudgetGuard budget_guard(budget);
+  int num_threads = PrepareParallelExecution(budget);
+  if (num_threads > 1) {
+    ExecuteInParallel([&](int index) { instrs_[index]->RunWithArgs(context->GetInstructionArgs(index), stream); },
+                      num_threads,
+                      budget);
+  } else {
+    for (int idx = 0; idx < instrs_.size(); ++idx) {
+      instrs_[idx]->RunWithArgs(context->GetInstructionArgs(idx), stream);
+    }
+  }
+#ifdef CINN_WITH_CUDA
+  if (!instrs_.empty() && instrs_[0]->target_.arch == Target::Arch::NVGPU && stream == nullptr) {
+    CUDA_CALL(cudaDeviceSynchronize());
+  }
+#endif
+}
+
 void Program::ExecuteTest(int repeat_) {
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
@@ -275,6 +667,12 @@ std::string GraphCompiler::GenSourceCode() {
   return compiler_->GetSourceCode(build_module);
 }
 
+std::string GraphCompiler::GetFusionGroupFuncName(Graph::Group* group) const {
+  auto func_name = group->GetFuncName();
+  auto it        = shared_func_names_.find(func_name);
+  return it == shared_func_names_.end() ? func_name : it->second;
+}
+
 const std::string& GraphCompiler::GetOrGenFullFuncName(const std::string& prefix) {
   // try_emplace only insert once, so the same function
   // can get a consistent name next time
@@ -687,6 +1085,124 @@ void GraphCompiler::CompileOptions::Apply(const auto_schedule::TuningResult& tun
   }
 }
 
+namespace {
+
+struct AttrStructureVisitor {
+  std::ostream& os;
+
+  void operator()(bool v) { os << "b" << v; }
+  void operator()(float v) { os << "f" << std::hexfloat << v << std::defaultfloat; }
+  void operator()(int v) { os << "i" << v; }
+  void operator()(const std::string& v) { os << "s" << v.size() << ":" << v; }
+  template <typename T>
+  void operator()(const std::vector<T>& vs) {
+    os << "v" << vs.size() << "[";
+    for (const T& v : vs) {
+      (*this)(v);
+      os << ",";
+    }
+    os << "]";
+  }
+};
+
+// Get the canonical structure of a fusion group from the op kinds and attributes of its nodes, the dtypes and shapes
+// of their variables and the topology inside the group. Variables are numbered in the order they are visited, which
+// is the order the group is lowered in, thus groups of a same structure are lowered to equivalent functions, and the
+// variables collected in `var_names` of such groups correspond one by one. The outermost extent of a symbolic variable
+// is only a probe value, so it is marked as `?`, which keeps static and symbolic groups from sharing functions, and
+// groups of a same structure pass CheckSymbolicOutputs of OpLowerer alike.
+std::string GetGroupStructure(const Graph::Group& group,
+                              const absl::flat_hash_map<std::string, Type>& dtype_dict,
+                              const absl::flat_hash_map<std::string, shape_t>& shape_dict,
+                              const absl::flat_hash_set<std::string>& symbolic_vars,
+                              std::vector<std::string>* var_names) {
+  std::ostringstream os;
+  absl::flat_hash_map<std::string, int> var_index;
+  auto visit_var = [&](const NodeData* var) {
+    CHECK(var);
+    auto id = var->id();
+    auto it = var_index.find(id);
+    if (it != var_index.end()) {
+      os << "%" << it->second;
+      return;
+    }
+    int index = var_names->size();
+    var_index.emplace(id, index);
+    var_names->push_back(id);
+    const auto& shape = shape_dict.at(id);
+    os << "%" << index << ":" << dtype_dict.at(id) << "[";
+    if (symbolic_vars.count(id) && !shape.empty()) {
+      os << "?" << (shape.size() > 1 ? "," : "") << utils::Join(shape_t(shape.begin() + 1, shape.end()), ",");
+    } else {
+      os << utils::Join(shape, ",");
+    }
+    os << "]";
+  };
+
+  auto visit_group = [&](const Graph::Group& sub_group) {
+    os << "group " << sub_group.op_pattern_kind << " " << sub_group.nodes.size() << "\n";
+    for (auto* node : sub_group.nodes) {
+      // the roles of a node decide how it is scheduled
+      os << node->op()->name << " " << group.output_nodes.count(node) << group.internal_nodes.count(node)
+         << group.master_nodes.count(node) << sub_group.output_nodes.count(node)
+         << sub_group.internal_nodes.count(node) << sub_group.master_nodes.count(node);
+
+      std::vector<std::string> attr_names;
+      for (auto& attr : node->attrs.attr_store) {
+        attr_names.push_back(attr.first);
+      }
+      std::sort(attr_names.begin(), attr_names.end());
+      AttrStructureVisitor visitor{os};
+      for (auto& name : attr_names) {
+        os << " " << name << "=";
+        absl::visit(visitor, node->attrs.attr_store.at(name));
+      }
+
+      os << " (";
+      for (auto& link : node->inlinks_in_order(true)) {
+        visit_var(link->source()->safe_as<NodeData>());
+        os << " ";
+      }
+      os << ") -> (";
+      for (auto& link : node->outlinks_in_order(true)) {
+        auto* var = link->sink()->safe_as<NodeData>();
+        visit_var(var);
+        os << "#" << var->outlinks().size() << " ";
+      }
+      os << ")\n";
+    }
+  };
+
+  os << "kind " << group.op_pattern_kind << "\n";
+  if (group.fused_sub_groups.empty()) {
+    visit_group(group);
+  } else {
+    for (auto& sub_group : group.fused_sub_groups) {
+      visit_group(*sub_group);
+    }
+  }
+  return os.str();
+}
+
+// Map the variables `names` of a group to the corresponding ones of another group of the same structure.
+std::vector<std::string> MapGroupVarNames(const std::vector<std::string>& names,
+                                          const std::vector<std::string>& from_vars,
+                                          const std::vector<std::string>& to_vars) {
+  CHECK_EQ(from_vars.size(), to_vars.size());
+  absl::flat_hash_map<std::string, std::string> var_map;
+  for (int i = 0; i < from_vars.size(); ++i) {
+    var_map.emplace(from_vars[i], to_vars[i]);
+  }
+  std::vector<std::string> res;
+  for (auto& name : names) {
+    CHECK(var_map.count(name)) << "Variable " << name << " is not found in the group structure";
+    res.push_back(var_map.at(name));
+  }
+  return res;
+}
+
+}  // namespace
+
 GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::CompileOptions& options,
                                                       std::unordered_set<std::string>&& fetch_var_ids,
                                                       void* stream) {
@@ -699,9 +1215,19 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
 
     GraphCompiler::CompilationResult compilation_result;
     compilation_result.runtime_program.reset(new Program(scope_, std::move(insts)));
+    compilation_result.runtime_program->SetSymbolicOuterDimVars(graph_->GetSymbolicOuterDimVars());
     return compilation_result;
   }
 
+  auto& symbolic_vars = graph_->GetSymbolicOuterDimVars();
+  if (!symbolic_vars.empty()) {
+    CHECK(target_ == common::DefaultHostTarget()) << "Symbolic dimension only supports X86 now!";
+    CHECK(!graph_->fusion_groups.empty() && options.groups.empty() && options.lowered_funcs.empty())
+        << "The graph with symbolic dimension should be lowered from the groups of OpFusionPass";
+    CHECK(!options.with_static_memory_plan && !options.with_inplace_outputs)
+        << "The memory of symbolic variables can't be planned at compile-time";
+  }
+
   Context::Global().ResetNameId();
   compile_options_ = options;
   fetch_var_ids_   = std::move(fetch_var_ids);
@@ -709,6 +1235,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   auto& nodes      = std::get<0>(topo_order);
   VLOG(3) << "Begin GraphCompiler::Build";
   m_builder_.Clear();
+  shared_func_names_.clear();
   // if there are no avaiable groups, we will take each node as a group
   if (options.groups.empty() && graph_->groups.empty() && graph_->fusion_groups.empty()) {
     VLOG(3) << "not run opfusion pass";
@@ -732,6 +1259,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   // if the input lowered_funcs is empty, we will use the defalut lowering process to generate
   std::vector<std::vector<ir::LoweredFunc>> local_lowered_funcs;
   if (options.lowered_funcs.empty()) {
+    utils::RecordEvent record_lowering("GraphCompiler::Lowering");
     // lowering of new fusion pass is not compatible with the groups from the input options,
     // thus process it seperately
     if (!graph_->fusion_groups.empty()) {
@@ -739,6 +1267,10 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
 
       OpLowerer op_lowerer(dtype_dict, shape_dict, target_);
+      op_lowerer.SetSymbolicOuterDimVars(symbolic_vars);
+      // the lowered groups and their variables in the order of structure, keyed by the structure
+      absl::flat_hash_map<std::string, std::pair<std::shared_ptr<Graph::Group>, std::vector<std::string>>>
+          lowered_structures;
       for (auto& group : graph_->fusion_groups) {
         VLOG(3) << "group_id is : " << group->group_id << ", and its number is : " << group->nodes.size();
         groups.push_back(std::move(group->CollectNodes()));
@@ -755,6 +1287,24 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
             }
           }
         }
+        // a group of the same structure as a lowered one shares its function rather than lowering and
+        // compiling it again, opaque groups are excluded as their instructions may depend on the nodes
+        if (FLAGS_cinn_share_identical_groups && options.groups.empty() && group->op_pattern_kind != kOpaque) {
+          std::vector<std::string> var_names;
+          auto structure = GetGroupStructure(*group, dtype_dict, shape_dict, symbolic_vars, &var_names);
+          auto it        = lowered_structures.find(structure);
+          if (it != lowered_structures.end()) {
+            auto& lowered_group = it->second.first;
+            auto& lowered_vars  = it->second.second;
+            group->input_names  = MapGroupVarNames(lowered_group->input_names, lowered_vars, var_names);
+            group->output_names = MapGroupVarNames(lowered_group->output_names, lowered_vars, var_names);
+            shared_func_names_[group->GetFuncName()] = GetFusionGroupFuncName(lowered_group.get());
+            VLOG(3) << "group " << group->group_id << " shares the function of group " << lowered_group->group_id;
+            local_lowered_funcs.emplace_back();
+            continue;
+          }
+          lowered_structures.emplace(std::move(structure), std::make_pair(group, std::move(var_names)));
+        }
         local_lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
         CHECK_EQ(local_lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
         VLOG(3) << local_lowered_funcs.back()[0];
@@ -787,6 +1337,8 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   const auto& lowered_funcs = options.lowered_funcs.empty() ? local_lowered_funcs : options.lowered_funcs;
   CHECK_EQ(groups.size(), lowered_funcs.size()) << "The size of groups and lowered_funcs shoule be equal";
   for (auto&& lowered_func : lowered_funcs) {
+    // empty for the groups sharing the function of another group
+    if (lowered_func.empty()) continue;
     this->ProcessFunction(lowered_func);
   }
   graph_->VisualizeGroupedGraph(groups, fetch_var_ids_);
@@ -805,8 +1357,12 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
     VLOG(3) << "[X86] C Code is:\n" << out;
   }
 
-  compiler_->Build(build_module, options.attached_code);
+  {
+    utils::RecordEvent record_jit("GraphCompiler::CodegenAndJit");
+    compiler_->Build(build_module, options.attached_code);
+  }
   VLOG(3) << "End of compiler_->Build";
+  utils::RecordEvent record_build_program("GraphCompiler::BuildProgram");
   auto instructions = BuildInstructions(groups, options.groups.empty() ? graph_->fusion_groups : options.groups);
 
   VLOG(3) << "End of BuildInstructions";
@@ -817,6 +1373,22 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
     VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
     InsertBufferHandlers(&instructions);
   }
+  // the variables whose memory each variable reuses after they dead
+  absl::flat_hash_map<std::string, std::vector<std::string>> reused_from;
+  if (options.with_inplace_outputs) {
+    CHECK(options.with_instantiate_variables) << "with_inplace_outputs shares buffers when instantiating variables";
+    CHECK(!options.with_buffer_handle_instruction_inserted)
+        << "with_inplace_outputs and with_buffer_handle_instruction_inserted can't be enabled at the same time";
+    VLOG(3) << "option.with_inplace_outputs enable";
+    AliasInplaceOutputs(groups, instructions, &reused_from);
+  }
+  std::unique_ptr<StaticMemoryPlanner> memory_planner;
+  if (options.with_static_memory_plan) {
+    CHECK(!options.with_buffer_handle_instruction_inserted)
+        << "with_static_memory_plan and with_buffer_handle_instruction_inserted can't be enabled at the same time";
+    VLOG(3) << "option.with_static_memory_plan enable";
+    memory_planner = PlanStaticMemory(instructions);
+  }
 
   if (options.with_instantiate_variables) {
     VLOG(3) << "Initantiate all variables on compile-time";
@@ -836,6 +1408,19 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   }
   GraphCompiler::CompilationResult result;
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+  if (memory_planner) {
+    for (auto& block : memory_planner->blocks()) {
+      auto prev_vars = memory_planner->GetReusedFrom(block.name);
+      if (!prev_vars.empty()) {
+        reused_from.emplace(block.name, std::move(prev_vars));
+      }
+    }
+    result.memory_plan_report = memory_planner->Report();
+  }
+  if (!reused_from.empty()) {
+    result.runtime_program->SetMemoryReuse(std::move(reused_from));
+  }
+  result.runtime_program->SetSymbolicOuterDimVars(symbolic_vars);
   return result;
 }
 
@@ -924,8 +1509,10 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
     if (group.size() == 1) {
       auto node       = group[0];
       auto instr_name = node->op()->name;
-      if (node->op()->name == "reshape" && compile_options_.with_instantiate_variables) {
-        // not run instruction and shares buffer only when instantiate_variables
+      if (node->op()->name == "reshape" && compile_options_.with_instantiate_variables &&
+          graph_->GetSymbolicOuterDimVars().empty()) {
+        // not run instruction and shares buffer only when instantiate_variables, the symbolic variables can't
+        // share buffer as they are resized at runtime
         auto& inlinks  = node->inlinks_in_order();
         auto& outlinks = node->outlinks_in_order();
         CHECK_EQ(inlinks.size(), 1U);
@@ -1082,7 +1669,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
         }
       }
       std::string op_func_name =
-          fusion_group.get() ? fusion_group->GetFuncName() : GetOrGenFullFuncName(GenOpFuncName(node));
+          fusion_group.get() ? GetFusionGroupFuncName(fusion_group.get()) : GetOrGenFullFuncName(GenOpFuncName(node));
       auto* fn_ptr = compiler_->Lookup(op_func_name);
       CHECK(fn_ptr);
       instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), op_func_name);
@@ -1140,7 +1727,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
         VLOG(3) << "input_names: " << utils::Join(inputNames, ", ");
         VLOG(3) << "out_names: " << utils::Join(outputNames, ", ");
       }
-      fuse_name = fusion_group.get() ? fusion_group->GetFuncName() : GetOrGenFullFuncName(fuse_name);
+      fuse_name = fusion_group.get() ? GetFusionGroupFuncName(fusion_group.get()) : GetOrGenFullFuncName(fuse_name);
       auto instr =
           std::unique_ptr<Instruction>(new Instruction(target_,
                                                        scope_.get(),
@@ -1300,6 +1887,207 @@ void GraphCompiler::InsertBufferHandlers(std::vector<std::unique_ptr<Instruction
   instructions->swap(results);
 }
 
+void GraphCompiler::AliasInplaceOutputs(const std::vector<std::vector<Node*>>& groups,
+                                        const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                        absl::flat_hash_map<std::string, std::vector<std::string>>* reused_from) {
+  // the kernels generated for devices declare their arguments __restrict__, so never alias them
+  if (target_.arch != Target::Arch::X86 || groups.size() != instructions.size()) {
+    VLOG(3) << "Skip aliasing in-place outputs of " << instructions.size() << " instructions on " << target_;
+    return;
+  }
+  auto& shape_dict      = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+
+  // the variable owning the buffer a variable shares
+  auto get_root = [this](std::string name) {
+    for (auto it = reuse_vars_map_.find(name); it != reuse_vars_map_.end(); it = reuse_vars_map_.find(name)) {
+      name = it->second;
+    }
+    return name;
+  };
+
+  // collect the lifetime of buffers keyed by their owners, a buffer can be reused only if it is written by an
+  // instruction, which excludes feeds and weights, and it is neither fetched nor used by pre-run instructions
+  absl::flat_hash_map<std::string, std::string> var2root;
+  absl::flat_hash_map<std::string, std::vector<std::string>> root2vars;
+  absl::flat_hash_map<std::string, int> first_written, last_used;
+  std::unordered_set<std::string> pinned_roots;
+  for (auto& fetch_var : fetch_var_ids_) {
+    pinned_roots.insert(get_root(fetch_var));
+  }
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr     = instructions[step];
+    auto visit_vars = [&](const std::vector<std::vector<std::string>>& args_list, bool is_write) {
+      for (auto& args : args_list) {
+        for (auto& var_name : args) {
+          auto root = get_root(var_name);
+          if (var2root.emplace(var_name, root).second) {
+            root2vars[root].push_back(var_name);
+          }
+          if (is_write) {
+            first_written.try_emplace(root, step);
+          }
+          last_used[root] = step;
+          if (instr->pre_run) {
+            pinned_roots.insert(root);
+          }
+        }
+      }
+    };
+    visit_vars(instr->GetInArgs(), false);
+    visit_vars(instr->GetOutArgs(), true);
+  }
+
+  // whether a group only reads the variable at the same positions it writes its output, the
+  // elementwise and broadcast ops consuming the variable keep its shape except slice_assign,
+  // which reads the assigned variable by offsets
+  auto is_position_wise = [&](const std::vector<Node*>& group, const std::string& var_name, const shape_t& shape) {
+    for (auto* node : group) {
+      auto kind = op_pattern_dict[node->op()];
+      if ((kind != kElemWise && kind != kBroadcast) || node->op()->name == "slice_assign") {
+        return false;
+      }
+      bool consumed = std::any_of(node->inlinks().begin(), node->inlinks().end(), [&](const auto& link) {
+        return link->source()->template safe_as<NodeData>()->id() == var_name;
+      });
+      if (!consumed) continue;
+      for (auto& link : node->outlinks()) {
+        auto out_id = link->sink()->template safe_as<NodeData>()->id();
+        if (!shape_dict.count(out_id) || shape_dict.at(out_id) != shape) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+
+  int num_aliased    = 0;
+  size_t saved_bytes = 0;
+  for (int idx = 0; idx < instructions.size(); ++idx) {
+    auto& instr = instructions[idx];
+    // a group writing multiple outputs may overwrite an input before the others read it
+    if (instr->pre_run || instr->GetInArgs().size() != 1 || instr->GetOutArgs().size() != 1 ||
+        instr->GetOutArgs().front().size() != 1) {
+      continue;
+    }
+    const auto& out_name = instr->GetOutArgs().front().front();
+    auto* out_var        = scope_->FindVar(out_name);
+    if (!out_var || get_root(out_name) != out_name) continue;
+    auto& out_tensor = absl::get<Tensor>(*out_var);
+
+    for (auto& in_name : instr->GetInArgs().front()) {
+      auto root = get_root(in_name);
+      if (root == out_name || !first_written.count(root) || first_written.at(root) >= idx ||
+          last_used.at(root) != idx || pinned_roots.count(root)) {
+        continue;
+      }
+      auto* in_var = scope_->FindVar(in_name);
+      if (!in_var) continue;
+      auto& in_tensor = absl::get<Tensor>(*in_var);
+      if (in_tensor->type() != out_tensor->type() || in_tensor->shape().data() != out_tensor->shape().data() ||
+          !is_position_wise(groups[idx], in_name, in_tensor->shape().data())) {
+        continue;
+      }
+
+      VLOG(3) << "Instruction-" << idx << " writes " << out_name << " in place into the buffer of " << in_name;
+      reuse_vars_map_[out_name] = root;
+      // the readers of the variables sharing the input's buffer must finish before the output is written, it is
+      // enough to wait for the ones sharing before this pass, as the earlier owners are waited by their successors
+      reused_from->emplace(out_name, root2vars.at(var2root.at(in_name)));
+      last_used[root] = std::max(last_used[root], last_used.at(out_name));
+      if (pinned_roots.count(out_name)) {
+        pinned_roots.insert(root);
+      }
+      ++num_aliased;
+      saved_bytes += out_tensor->shape().numel() * out_tensor->type().bytes();
+      break;
+    }
+  }
+
+  // point every variable to the owner of its buffer directly, so they can be instantiated in any order
+  for (auto& dst2src : reuse_vars_map_) {
+    dst2src.second = get_root(dst2src.second);
+  }
+  VLOG(3) << num_aliased << " outputs are written in place, which saves " << saved_bytes << " bytes";
+}
+
+std::unique_ptr<StaticMemoryPlanner> GraphCompiler::PlanStaticMemory(
+    const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  std::unordered_map<int, std::vector<std::string>> step2malloc, step2free;
+  AnalyzeVariableLifeTime(instructions, &step2malloc, &step2free);
+  absl::flat_hash_map<std::string, int> variable_first_used, variable_last_used;
+  for (auto& step_vars : step2malloc) {
+    for (auto& var_name : step_vars.second) {
+      variable_first_used[var_name] = step_vars.first;
+    }
+  }
+  for (auto& step_vars : step2free) {
+    for (auto& var_name : step_vars.second) {
+      variable_last_used[var_name] = step_vars.first;
+    }
+  }
+
+  // only the variables produced and consumed inside the program are intermediate, the variables
+  // never written are feeds or weights, and the ones used by pre-run instructions must stay alive
+  std::unordered_set<std::string> written_vars, excluded_vars(fetch_var_ids_.begin(), fetch_var_ids_.end());
+  for (auto& instr : instructions) {
+    for (auto& args : instr->GetOutArgs()) {
+      written_vars.insert(args.begin(), args.end());
+    }
+    if (instr->pre_run || instr->size() == 4) {
+      for (auto& args : instr->GetInArgs()) {
+        excluded_vars.insert(args.begin(), args.end());
+      }
+      for (auto& args : instr->GetOutArgs()) {
+        excluded_vars.insert(args.begin(), args.end());
+      }
+    }
+  }
+  // variables sharing buffer with another one are not planned
+  for (auto& dst2src : reuse_vars_map_) {
+    excluded_vars.insert(dst2src.first);
+    excluded_vars.insert(dst2src.second);
+  }
+
+  auto planner = std::make_unique<StaticMemoryPlanner>();
+  // iterate in the order of instructions to make the plan deterministic
+  for (auto step = 0; step < instructions.size(); ++step) {
+    auto it = step2malloc.find(step);
+    if (it == step2malloc.end()) continue;
+    for (auto& var_name : it->second) {
+      if (!written_vars.count(var_name) || excluded_vars.count(var_name) || planner->Contains(var_name)) {
+        continue;
+      }
+      auto* var = scope_->FindVar(var_name);
+      if (!var) continue;
+      auto& tensor = absl::get<Tensor>(*var);
+      size_t bytes = tensor->shape().numel() * tensor->type().bytes();
+      if (tensor->buffer()->memory || bytes == 0) continue;
+      planner->AddVariable(var_name, bytes, variable_first_used.at(var_name), variable_last_used.at(var_name));
+    }
+  }
+  planner->Plan();
+  VLOG(3) << planner->Report();
+  if (planner->arena_size() == 0) {
+    return planner;
+  }
+
+  // allocate the arena and bind buffers of the variables only once
+  auto arena = std::make_shared<Buffer>(target_);
+  if (target_ == common::DefaultHostTarget()) {
+    arena->Resize(1024, planner->arena_size());
+  } else {
+    arena->Resize(planner->arena_size());
+  }
+  for (auto& block : planner->blocks()) {
+    auto tensor = scope_->GetTensor(block.name);
+    tensor->get_buffer()->SetTarget(target_);
+    tensor->get_buffer()->BindExternalMemory(arena->data()->memory + block.offset, block.size, arena);
+    VLOG(4) << "Variable(" << block.name << ") is bound to the arena at offset " << block.offset;
+  }
+  return planner;
+}
+
 std::vector<std::string> GraphCompiler::OpGetInputNames(const Node* node) const {
   std::vector<std::string> res;
   if (node->op()->name == "cublas_gemm" || node->op()->name == "cublas_matmul" || node->op()->name == "conv2d" ||
@@ -15,9 +15,12 @@
 #pragma once
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -27,13 +30,16 @@
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/macros.h"
+#include "cinn/hlir/framework/execution_context.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/memory_planner.h"
 #include "cinn/hlir/framework/op_strategy.h"
 #include "cinn/hlir/framework/parallel_compiler.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/lang/packed_func.h"
+#include "cinn/runtime/cpu/thread_pool.h"
 #include "cinn/utils/timer.h"
 
 namespace cinn {
@@ -63,6 +69,19 @@ class Program {
                void* stream                                                = nullptr,
                bool use_cache                                              = true);
 
+  /**
+   * Create a context to execute the program for one request.
+   * @param input_names The variables fed by each request, they own private tensors in the context together with all
+   * the variables written by instructions, and the others such as weights are shared with the scope of the program.
+   */
+  std::unique_ptr<ExecutionContext> CreateExecutionContext(const std::vector<std::string>& input_names = {}) const;
+
+  /**
+   * Execute the program on the tensors of \p context, different contexts can be executed by multiple threads at the
+   * same time.
+   */
+  void Execute(ExecutionContext* context, void* stream = nullptr);
+
   void ExecuteTest(int repeat_);
 
   /**
@@ -73,13 +92,92 @@ class Program {
   const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() { return prerun_instrs_; }
   const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() { return instrs_; }
 
+  /**
+   * Set the variables sharing memory by the static memory plan.
+   * @param reused_from Mapping a variable to the variables whose memory it reuses after they dead.
+   */
+  void SetMemoryReuse(absl::flat_hash_map<std::string, std::vector<std::string>>&& reused_from) {
+    memory_reused_from_ = std::move(reused_from);
+    dependency_built_   = false;
+  }
+  const absl::flat_hash_map<std::string, std::vector<std::string>>& GetMemoryReuse() const {
+    return memory_reused_from_;
+  }
+
+  /**
+   * Set the variables whose outermost dimension is symbolic, see Graph::GetSymbolicOuterDimVars. Before each
+   * execution, the variables written by instructions are resized to the outermost extent of the fed ones.
+   */
+  void SetSymbolicOuterDimVars(const absl::flat_hash_set<std::string>& symbolic_vars);
+
+  //! The variables whose outermost dimension is symbolic, including both the fed ones and the written ones.
+  absl::flat_hash_set<std::string> GetSymbolicOuterDimVars() const;
+
+  /**
+   * Run the program within a slice of the cores, which is split between the threads running independent instructions,
+   * and each of them launches its parallel loops within its own part. An execution context may have its own budget
+   * instead.
+   */
+  void SetThreadBudget(const std::shared_ptr<runtime::cpu::ThreadBudget>& budget) { thread_budget_ = budget; }
+
  private:
+  // resize the symbolic variables written by instructions to the outermost extent of the symbolic feeds
+  void ResizeSymbolicVars(const std::map<std::string, cinn_pod_value_t>* name2podargs);
+
+  // build the dependency DAG of instrs_ from their arguments, an instruction
+  // depends on another one if they access a same variable and at least one writes it
+  void BuildInstructionDependency();
+
+  // the number of threads to run instrs_ within `budget`, which builds the dependency DAG on the first call
+  int PrepareParallelExecution(const runtime::cpu::ThreadBudget* budget);
+
+  // flatten the functions of instrs_ with their cached arguments into launch_plan_,
+  // the args cache of an instruction is updated first if it is not ready
+  void BuildLaunchPlan(const std::map<std::string, cinn_pod_value_t>* name2podargs);
+
+  // run launch_plan_ sequentially, which does no string work or allocation
+  void RunLaunchPlan(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream);
+
+  // run instrs_ on `num_threads` threads by `run_instr`, an instruction is launched once all its predecessors in the
+  // dependency DAG finished, and each thread takes a part of `budget` if it is not null
+  void ExecuteInParallel(const std::function<void(int)>& run_instr,
+                         int num_threads,
+                         runtime::cpu::ThreadBudget* budget);
+
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
   // prerun instructions
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+
+  // a function to launch with a span of the args cache of its instruction
+  struct LaunchStep {
+    void* fn_ptr;
+    cinn_pod_value_t* args;
+    int num_args;
+    Instruction::LaunchKind kind;
+    Instruction* instr;
+  };
+  // the flat launch plan of instrs_ built on the first sequential execution using
+  // the args cache, and it is invalidated once the args cache may be rebuilt
+  std::vector<LaunchStep> launch_plan_;
+  bool launch_plan_built_ = false;
+
+  // the dependency DAG of instrs_, which is built once on the first parallel execution
+  std::mutex dependency_mtx_;
+  bool dependency_built_ = false;
+  // whether all instructions run on host, instructions on device are always executed sequentially
+  bool parallel_executable_ = false;
+  std::vector<std::vector<int>> instr_successors_;
+  std::vector<int> instr_in_degree_;
+  // the instructions using a variable should wait for all instructions using the variables whose memory it reuses
+  absl::flat_hash_map<std::string, std::vector<std::string>> memory_reused_from_;
+  // the symbolic variables fed by users and the ones written by instructions
+  std::vector<std::string> symbolic_feed_vars_;
+  std::vector<std::string> symbolic_written_vars_;
+  // the slice of the cores to run on, unlimited if it is null
+  std::shared_ptr<runtime::cpu::ThreadBudget> thread_budget_;
 };
 
 /**
@@ -92,6 +190,8 @@ class GraphCompiler final {
 
   struct CompilationResult {
     std::unique_ptr<Program> runtime_program;
+    // the summary of static memory plan, empty if it is not enabled
+    std::string memory_plan_report;
   };
 
   struct CompileOptions {
@@ -99,6 +199,13 @@ class GraphCompiler final {
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
     bool remove_unused_variables                 = true;
+    // pack intermediate variables into one pre-allocated arena according to their lifetime,
+    // it is exclusive with with_buffer_handle_instruction_inserted
+    bool with_static_memory_plan = false;
+    // let an elementwise or broadcast group write its output into the buffer of a dead input
+    // of the same shape and dtype, it requires with_instantiate_variables and is exclusive
+    // with with_buffer_handle_instruction_inserted
+    bool with_inplace_outputs = false;
     // nodes group, it may come from the result of op fusion or graph tuning.
     // nodes in a group will be built into an Instruction
     std::vector<std::shared_ptr<Graph::Group>> groups;
@@ -115,6 +222,10 @@ class GraphCompiler final {
                           std::unordered_set<std::string>&& fetch_var_ids = {},
                           void* stream                                    = nullptr);
   void ExportObject(const std::string& path) { compiler_->ExportObject(path); }
+  std::string GetObjectCode() const {
+    CHECK(compiler_) << "The object code is available after built without parallel compiling";
+    return compiler_->GetObjectCode();
+  }
 
   std::unique_ptr<Program> Build(const std::string& code = "");
 
@@ -139,6 +250,9 @@ class GraphCompiler final {
   // different functions from graphs whose structures are same
   const std::string& GetOrGenFullFuncName(const std::string& prefix);
 
+  // the name of the function a fusion group runs, which may be lowered from another group of the same structure
+  std::string GetFusionGroupFuncName(Graph::Group* group) const;
+
   // TODO(haozech) add implementation
   std::vector<std::string> OpGetInputNames(const Node* node) const;
   // TODO(haozech) add implementation
@@ -165,6 +279,17 @@ class GraphCompiler final {
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
+  // pack intermediate variables into one arena with fixed offsets according to their
+  // lifetime, and bind the buffers of these variables to the arena once
+  std::unique_ptr<StaticMemoryPlanner> PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  // make the output of an elementwise or broadcast group reuse the buffer of an input which is written by a
+  // previous instruction and never used after the group, by adding them into reuse_vars_map_, and record the
+  // variables whose memory each output reuses into `reused_from`
+  void AliasInplaceOutputs(const std::vector<std::vector<Node*>>& groups,
+                           const std::vector<std::unique_ptr<Instruction>>& instructions,
+                           absl::flat_hash_map<std::string, std::vector<std::string>>* reused_from);
+
  private:
   // parallel compiler
   std::shared_ptr<ParallelCompiler> parallel_compiler_;
@@ -184,6 +309,8 @@ class GraphCompiler final {
   absl::flat_hash_map<std::string, std::string> prefix2full_namemap_;
   // map dst reuse var to the src var sharing buffer
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
+  // map the function name of a fusion group to the function of the group of the same structure it shares
+  absl::flat_hash_map<std::string, std::string> shared_func_names_;
 
   std::unique_ptr<backends::Compiler> compiler_;
   CompileOptions compile_options_;
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/program_pass.h"
@@ -117,6 +119,137 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestShareIdenticalGroups) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {32, 16}, "A");
+  auto b = builder.CreateInput(Float(32), {32, 16}, "B");
+  auto c = builder.CreateInput(Float(32), {32, 16}, "C");
+  auto d = builder.CreateInput(Float(32), {32, 16}, "D");
+  // two independent blocks of the same structure
+  auto e = builder.Relu(builder.Add(a, b));
+  auto f = builder.Relu(builder.Add(c, d));
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program     = gc.Build();
+  const auto& instructions = runtime_program->GetRunInstructions();
+  ASSERT_EQ(instructions.size(), 2);
+  ASSERT_EQ(instructions[0]->GetFnNames(), instructions[1]->GetFnNames());
+  ASSERT_NE(instructions[0]->GetInArgs(), instructions[1]->GetInArgs());
+
+  std::vector<std::string> input_names = {"A", "B", "C", "D"};
+  for (auto& name : input_names) {
+    SetRandData<float>(scope->GetTensor(name), target);
+  }
+  runtime_program->Execute();
+
+  auto check_block = [&](const std::string& x, const std::string& y, const std::string& out) {
+    auto host_x   = GetTensorData<float>(scope->GetTensor(x), target);
+    auto host_y   = GetTensorData<float>(scope->GetTensor(y), target);
+    auto host_out = GetTensorData<float>(scope->GetTensor(out), target);
+    for (int i = 0; i < host_out.size(); i++) {
+      EXPECT_FLOAT_EQ(host_out[i], std::max(host_x[i] + host_y[i], 0.f));
+    }
+  };
+  check_block("A", "B", e->id);
+  check_block("C", "D", f->id);
+}
+
+TEST(GraphCompilerTest, TestSymbolicOuterDim) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {Graph::kSymbolicDim, 16}, "A");
+  auto b = builder.CreateInput(Float(32), {Graph::kSymbolicDim, 16}, "B");
+  auto c = builder.Relu(builder.Multiply(builder.Add(a, b), b));
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = std::make_shared<Graph>(program, target);
+  ApplyPass(graph.get(), "InferShape");
+  ApplyPass(graph.get(), "OpFusionPass");
+  ApplyPass(graph.get(), "FusionMergePass");
+  ASSERT_TRUE(graph->GetSymbolicOuterDimVars().count("A"));
+  ASSERT_TRUE(graph->GetSymbolicOuterDimVars().count(c->id));
+  auto scope = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto result                        = gc.Build(options, {c->id});
+
+  // the program compiled once runs with any outermost extent of the feeds
+  for (int extent : {3, 40, 5}) {
+    for (auto& name : {"A", "B"}) {
+      auto tensor = scope->GetTensor(name);
+      tensor->Resize(Shape({extent, 16}));
+      SetRandData<float>(tensor, target);
+    }
+    result.runtime_program->Execute();
+
+    auto out = scope->GetTensor(c->id);
+    ASSERT_EQ(out->shape().data(), std::vector<int>({extent, 16}));
+    auto host_a   = GetTensorData<float>(scope->GetTensor("A"), target);
+    auto host_b   = GetTensorData<float>(scope->GetTensor("B"), target);
+    auto host_out = GetTensorData<float>(out, target);
+    ASSERT_EQ(host_out.size(), extent * 16);
+    for (int i = 0; i < host_out.size(); i++) {
+      EXPECT_FLOAT_EQ(host_out[i], std::max((host_a[i] + host_b[i]) * host_b[i], 0.f));
+    }
+  }
+}
+
+TEST(GraphCompilerTest, TestSymbolicGroupNotShareStaticFunction) {
+  frontend::NetBuilder builder("test");
+  // the static block is lowered first, and its outermost extent equals the probe of the symbolic dimension
+  auto c = builder.CreateInput(Float(32), {17, 16}, "C");
+  auto d = builder.CreateInput(Float(32), {17, 16}, "D");
+  auto a = builder.CreateInput(Float(32), {Graph::kSymbolicDim, 16}, "A");
+  auto b = builder.CreateInput(Float(32), {Graph::kSymbolicDim, 16}, "B");
+  auto f = builder.Relu(builder.Add(c, d));
+  auto e = builder.Relu(builder.Add(a, b));
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = std::make_shared<Graph>(program, target);
+  ApplyPass(graph.get(), "InferShape");
+  ApplyPass(graph.get(), "OpFusionPass");
+  ApplyPass(graph.get(), "FusionMergePass");
+  auto scope = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto result                        = gc.Build(options, {e->id, f->id});
+  const auto& instructions           = result.runtime_program->GetRunInstructions();
+  ASSERT_EQ(instructions.size(), 2);
+  ASSERT_NE(instructions[0]->GetFnNames(), instructions[1]->GetFnNames());
+
+  for (auto& name : {"A", "B"}) {
+    auto tensor = scope->GetTensor(name);
+    tensor->Resize(Shape({5, 16}));
+    SetRandData<float>(tensor, target);
+  }
+  for (auto& name : {"C", "D"}) {
+    SetRandData<float>(scope->GetTensor(name), target);
+  }
+  result.runtime_program->Execute();
+
+  auto check_block = [&](const std::string& x, const std::string& y, const std::string& out, int extent) {
+    auto host_x   = GetTensorData<float>(scope->GetTensor(x), target);
+    auto host_y   = GetTensorData<float>(scope->GetTensor(y), target);
+    auto host_out = GetTensorData<float>(scope->GetTensor(out), target);
+    ASSERT_EQ(host_out.size(), extent * 16);
+    for (int i = 0; i < host_out.size(); i++) {
+      EXPECT_FLOAT_EQ(host_out[i], std::max(host_x[i] + host_y[i], 0.f));
+    }
+  };
+  check_block("A", "B", e->id, 5);
+  check_block("C", "D", f->id, 17);
+}
+
 #ifdef CINN_WITH_CUDA
 std::vector<float> test_mul(const std::vector<float>& A, const std::vector<float>& B, int M, int K, int N) {
   std::vector<float> C_target(M * N);
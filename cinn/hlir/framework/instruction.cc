@@ -14,6 +14,8 @@
 
 #include "cinn/hlir/framework/instruction.h"
 
+#include <unordered_set>
+
 #include "cinn/common/test_helper.h"
 #include "cinn/hlir/framework/accuracy_checker.h"
 #include "cinn/utils/profiler.h"
@@ -25,6 +27,25 @@ namespace cinn {
 namespace hlir {
 namespace framework {
 
+uint64_t GetArgsBytes(const cinn_pod_value_t* args, int num_args) {
+  uint64_t bytes = 0;
+  for (int i = 0; i < num_args; ++i) {
+    if (args[i].type_code() == ::cinn_type_code<cinn_buffer_t*>()) {
+      cinn_buffer_t* buffer = args[i];
+      bytes += buffer->memory_size;
+    }
+  }
+  return bytes;
+}
+
+uint64_t GetArgsBytes(const std::vector<std::vector<cinn_pod_value_t>>& args_list) {
+  uint64_t bytes = 0;
+  for (auto& args : args_list) {
+    bytes += GetArgsBytes(args.data(), args.size());
+  }
+  return bytes;
+}
+
 void Instruction::UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
   int cache_size = size();
   args_cached_.resize(cache_size);
@@ -54,6 +75,23 @@ void Instruction::UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>*
   }
 }
 
+std::vector<std::vector<cinn_pod_value_t>> Instruction::BuildArgs(const Scope& scope) const {
+  std::vector<std::vector<cinn_pod_value_t>> args_list(fn_ptrs_.size());
+  for (int i = 0; i < fn_ptrs_.size(); ++i) {
+    common::ArgsBuilder builder;
+    std::vector<std::string> all_args = in_args_[i];
+    all_args.insert(std::end(all_args), out_args_[i].begin(), out_args_[i].end());
+    for (const auto& arg : all_args) {
+      auto* var = scope.FindVar(arg);
+      CHECK(var) << "Argument [" << arg << "] not found in the scope";
+      auto& tensor = absl::get<Tensor>(*var);
+      builder.Add(tensor->buffer());
+    }
+    args_list[i] = builder.Build();
+  }
+  return args_list;
+}
+
 void Instruction::Finalize() {
   if (fn_ptrs_.size() > 1 && fn_ptrs_.size() != in_args_.size()) {
     out_args_.back()[0] = out_args_.front()[0];
@@ -61,9 +99,30 @@ void Instruction::Finalize() {
     in_args_.erase(in_args_.begin());
   }
 
+  launch_kind_    = ResolveLaunchKind();
   finalized_flag_ = true;
 }
 
+Instruction::LaunchKind Instruction::ResolveLaunchKind() const {
+  if (function_name_ == "no_run") {
+    return LaunchKind::kNoRun;
+  }
+  if (target_.arch == Target::Arch::NVGPU) {
+#if defined(CINN_WITH_CUDNN)
+    static const std::unordered_set<std::string> external_funcs = {
+        "conv2d", "depthwise_conv2d", "pool2d", "softmax", "mul", "cublas_gemm", "cublas_matmul"};
+#elif defined(CINN_WITH_CUDA)
+    static const std::unordered_set<std::string> external_funcs = {"cublas_gemm", "cublas_matmul"};
+#else
+    static const std::unordered_set<std::string> external_funcs = {};
+#endif
+    if (external_funcs.count(function_name_)) {
+      return LaunchKind::kExternal;
+    }
+  }
+  return target_ == common::DefaultNVGPUTarget() ? LaunchKind::kDevice : LaunchKind::kHost;
+}
+
 void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs,
                       bool dryrun,
                       void* stream,
@@ -84,15 +143,61 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     }
   }
 
+  if (record_run.recording()) {
+    record_run.SetArgBytes(GetArgsBytes(args_cached_));
+  }
+  LaunchFunctions(&args_cached_, dryrun, stream);
+
+  if (FLAGS_cinn_self_check_accuracy) {
+    CheckResults(name2podargs, stream);
+#ifdef CINN_WITH_CUDA
+  } else if (FLAGS_cinn_sync_run) {
+    utils::RecordEvent record_sync("Synchronize");
+    auto st = cudaStreamSynchronize(static_cast<cudaStream_t>(stream));
+    if (st) {
+      LOG(FATAL) << "cuda error -> " << cudaGetErrorString(st);
+    }
+#endif
+  }
+}
+
+void Instruction::RunWithArgs(std::vector<std::vector<cinn_pod_value_t>>* args, void* stream) const {
+  utils::RecordEvent record_run(function_name_);
+  CHECK(finalized_flag_) << "Instruction must be finalized before run";
+  if (function_name_ == "no_run") {
+    VLOG(2) << "skip instruction";
+    return;
+  }
+  CHECK_EQ(args->size(), fn_ptrs_.size()) << "The arguments should be built by BuildArgs of this instruction";
+
+  VLOG(2) << "Run function " << function_name_ << " with the given arguments";
+  if (record_run.recording()) {
+    record_run.SetArgBytes(GetArgsBytes(*args));
+  }
+  LaunchFunctions(args, false, stream);
+
+#ifdef CINN_WITH_CUDA
+  if (FLAGS_cinn_sync_run) {
+    utils::RecordEvent record_sync("Synchronize");
+    auto st = cudaStreamSynchronize(static_cast<cudaStream_t>(stream));
+    if (st) {
+      LOG(FATAL) << "cuda error -> " << cudaGetErrorString(st);
+    }
+  }
+#endif
+}
+
+void Instruction::LaunchFunctions(std::vector<std::vector<cinn_pod_value_t>>* args, bool dryrun, void* stream) const {
+  auto& args_list = *args;
   utils::ProfilerRangePush("Compute");
 #if defined(CINN_WITH_CUDA) && !defined(CINN_WITH_CUDNN)
   if (function_name_ == "cublas_gemm" && target_.arch == Target::Arch::NVGPU) {
-    auto& pod_args = args_cached_[0];
+    auto& pod_args = args_list[0];
     VLOG(3) << "The pod_args size of cublas_gemm: " << pod_args.size();
     runtime::cuda::cinn_gpu_cublas_gemm(
         attrs, pod_args[0], pod_args[1], pod_args[2], pod_args[3], static_cast<cudaStream_t>(stream));
   } else if (function_name_ == "cublas_matmul" && target_.arch == Target::Arch::NVGPU) {
-    auto& pod_args = args_cached_[0];
+    auto& pod_args = args_list[0];
     VLOG(3) << "The pod_args size of cublas_matmul: " << pod_args.size();
     runtime::cuda::cinn_gpu_cublas_gemm(
         attrs, pod_args[0], pod_args[1], nullptr, pod_args[2], static_cast<cudaStream_t>(stream));
@@ -100,7 +205,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     VLOG(3) << "Runing extern function " << function_name_;
     for (int idx = 0; idx < fn_ptrs_.size(); ++idx) {
       VLOG(3) << "Runing func name: " << fn_names_[idx];
-      auto& pod_args = args_cached_[idx];
+      auto& pod_args = args_list[idx];
       CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
       if (!dryrun) {
         if (target_ == common::DefaultNVGPUTarget()) {
@@ -113,7 +218,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     VLOG(3) << "Done Runing extern function " << function_name_;
   }
 #elif defined(CINN_WITH_CUDNN)
-  auto& pod_args = args_cached_[0];
+  auto& pod_args = args_list[0];
   // Here conv2d and depthwise_conv2d are implemented by one cudnn api cudnnConvolutionForward
   if ((function_name_ == "conv2d" || function_name_ == "depthwise_conv2d") && target_.arch == Target::Arch::NVGPU) {
     if (str_attrs[0] == "forward") {
@@ -176,7 +281,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     runtime::cuda::cinn_gpu_cublas_gemm(
         attrs, pod_args[0], pod_args[1], pod_args[2], pod_args[3], static_cast<cudaStream_t>(stream));
   } else if (function_name_ == "cublas_matmul" && target_.arch == Target::Arch::NVGPU) {
-    auto& pod_args = args_cached_[0];
+    auto& pod_args = args_list[0];
     VLOG(3) << "The pod_args size of cublas_matmul: " << pod_args.size();
     runtime::cuda::cinn_gpu_cublas_gemm(
         attrs, pod_args[0], pod_args[1], nullptr, pod_args[2], static_cast<cudaStream_t>(stream));
@@ -184,7 +289,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     VLOG(3) << "Runing extern function " << function_name_;
     for (int idx = 0; idx < fn_ptrs_.size(); ++idx) {
       VLOG(3) << "Runing func name: " << fn_names_[idx];
-      auto& pod_args = args_cached_[idx];
+      auto& pod_args = args_list[idx];
       CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
       if (!dryrun) {
         if (target_ == common::DefaultNVGPUTarget()) {
@@ -200,7 +305,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
   VLOG(3) << "Runing extern function " << function_name_;
   for (int idx = 0; idx < fn_ptrs_.size(); ++idx) {
     VLOG(3) << "Runing func name: " << fn_names_[idx];
-    auto& pod_args = args_cached_[idx];
+    auto& pod_args = args_list[idx];
     CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
     if (!dryrun) {
       if (target_ == common::DefaultNVGPUTarget()) {
@@ -213,18 +318,6 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
   VLOG(3) << "Done Runing extern function " << function_name_;
 #endif
   utils::ProfilerRangePop();
-
-  if (FLAGS_cinn_self_check_accuracy) {
-    CheckResults(name2podargs, stream);
-#ifdef CINN_WITH_CUDA
-  } else if (FLAGS_cinn_sync_run) {
-    utils::RecordEvent record_sync("Synchronize");
-    auto st = cudaStreamSynchronize(static_cast<cudaStream_t>(stream));
-    if (st) {
-      LOG(FATAL) << "cuda error -> " << cudaGetErrorString(st);
-    }
-#endif
-  }
 }
 
 void Instruction::CheckResults(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
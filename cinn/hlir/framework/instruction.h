@@ -40,6 +40,14 @@ class Instruction {
  public:
   using infershape_t = std::function<void(Scope*, const std::vector<std::string>&)>;
 
+  //! How the functions of an instruction are launched, it is resolved once by Finalize.
+  enum class LaunchKind : int {
+    kNoRun = 0,  // skipped, such as a reshape sharing buffer with its input
+    kHost,       // call the host functions by lower_func_ptr_t
+    kDevice,     // call the device functions by lower_func_ptr_g with a stream
+    kExternal,   // dispatched to cuBLAS/cuDNN by Run
+  };
+
   /**
    * Constructor.
    * @param target The \p target the instruction runs on.
@@ -76,6 +84,16 @@ class Instruction {
            void* stream                                                = nullptr,
            bool use_cache                                              = true);
 
+  /**
+   * Collect the arguments of all the functions from the tensors in \p scope, the args cache is untouched.
+   */
+  std::vector<std::vector<cinn_pod_value_t>> BuildArgs(const Scope& scope) const;
+
+  /**
+   * Run the Instruction with the arguments built by BuildArgs, it is re-entrant as it never touches the args cache.
+   */
+  void RunWithArgs(std::vector<std::vector<cinn_pod_value_t>>* args, void* stream = nullptr) const;
+
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) {
     CHECK_EQ(fn_ptrs_.size(), 4);
     if (fn_ptrs_.size() > 1 && fn_ptrs_.size() != in_args_.size()) {
@@ -117,6 +135,14 @@ class Instruction {
 
   int size() { return fn_ptrs_.size(); }
 
+  LaunchKind launch_kind() const { return launch_kind_; }
+  const std::string& function_name() const { return function_name_; }
+
+  //! Whether the args cache matches the functions, it is reset by UpdateArgsCache.
+  bool IsArgsCached() const { return args_cached_.size() == fn_ptrs_.size(); }
+  const std::vector<void*>& GetFnPtrs() const { return fn_ptrs_; }
+  std::vector<std::vector<cinn_pod_value_t>>& GetArgsCache() { return args_cached_; }
+
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
   void ClearInArgs() { in_args_.clear(); }
@@ -133,7 +159,13 @@ class Instruction {
   void CheckResults(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr, void* stream = nullptr);
 
  private:
-  bool finalized_flag_ = false;
+  // call the functions one by one with the corresponding arguments in \p args
+  void LaunchFunctions(std::vector<std::vector<cinn_pod_value_t>>* args, bool dryrun, void* stream) const;
+
+  LaunchKind ResolveLaunchKind() const;
+
+  bool finalized_flag_     = false;
+  LaunchKind launch_kind_ = LaunchKind::kHost;
   Scope* scope_{};
   std::string function_name_;
   std::vector<std::vector<std::string>> in_args_;
@@ -145,6 +177,10 @@ class Instruction {
   std::vector<std::string> fn_names_;
 };
 
+//! Get the total bytes of the buffers in the arguments, which is recorded by the host profiler.
+uint64_t GetArgsBytes(const cinn_pod_value_t* args, int num_args);
+uint64_t GetArgsBytes(const std::vector<std::vector<cinn_pod_value_t>>& args_list);
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
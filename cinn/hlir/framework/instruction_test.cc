@@ -81,7 +81,9 @@ TEST(Instruction, basic) {
   // should call Finalize explicitly before Run
   ASSERT_DEATH(instr.Run(), "");
   instr.Finalize();
+  ASSERT_EQ(instr.launch_kind(), Instruction::LaunchKind::kHost);
   instr.Run();
+  ASSERT_TRUE(instr.IsArgsCached());
 
   // check result
   {
@@ -14,6 +14,10 @@
 
 #include "cinn/hlir/framework/memory.h"
 
+#include <gflags/gflags.h>
+
+#include "cinn/hlir/framework/caching_memory.h"
+
 #ifdef CINN_WITH_CUDA
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -21,6 +25,10 @@
 #include "cinn/backends/cuda_util.h"
 #endif
 
+DECLARE_bool(cinn_x86_caching_allocator);
+DECLARE_bool(cinn_x86_caching_allocator_huge_page);
+DECLARE_int32(cinn_x86_caching_allocator_max_cached_mb);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -57,7 +65,13 @@ class CudaMemoryMng : public MemoryInterface {
 
 MemoryManager::MemoryManager() {
   Register(Target::Arch::Unk, new X86MemoryMng);
-  Register(Target::Arch::X86, new X86MemoryMng);
+  if (FLAGS_cinn_x86_caching_allocator) {
+    Register(Target::Arch::X86,
+             new X86CachingMemoryMng(static_cast<size_t>(FLAGS_cinn_x86_caching_allocator_max_cached_mb) << 20,
+                                     FLAGS_cinn_x86_caching_allocator_huge_page));
+  } else {
+    Register(Target::Arch::X86, new X86MemoryMng);
+  }
 #ifdef CINN_WITH_CUDA
   Register(Target::Arch::NVGPU, new CudaMemoryMng);
 #endif
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+StaticMemoryPlanner::StaticMemoryPlanner(size_t alignment) : alignment_(alignment) {
+  CHECK_GT(alignment_, 0) << "The alignment should be greater than 0";
+}
+
+void StaticMemoryPlanner::AddVariable(const std::string& name, size_t size, int first_step, int last_step) {
+  CHECK(!planned_) << "Can't add variable [" << name << "] after planning";
+  CHECK(!name2index_.count(name)) << "Duplicate variable [" << name << "]";
+  CHECK_LE(first_step, last_step) << "The lifetime of variable [" << name << "] is invalid";
+  name2index_[name] = blocks_.size();
+  blocks_.push_back(Block{name, Align(size), first_step, last_step, 0});
+  naive_size_ += Align(size);
+}
+
+void StaticMemoryPlanner::Plan() {
+  CHECK(!planned_) << "The StaticMemoryPlanner has planned";
+  std::vector<int> order(blocks_.size());
+  for (int i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  // place larger variables firstly, and earlier ones for the same size to make the result stable
+  std::sort(order.begin(), order.end(), [this](int lhs, int rhs) {
+    if (blocks_[lhs].size != blocks_[rhs].size) {
+      return blocks_[lhs].size > blocks_[rhs].size;
+    }
+    return blocks_[lhs].first_step < blocks_[rhs].first_step;
+  });
+
+  std::vector<int> placed;
+  for (int idx : order) {
+    auto& block = blocks_[idx];
+    // the placed variables alive at the same time with current one
+    std::vector<const Block*> conflicts;
+    for (int other : placed) {
+      const auto& other_block = blocks_[other];
+      if (other_block.first_step <= block.last_step && block.first_step <= other_block.last_step) {
+        conflicts.push_back(&other_block);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [](const Block* lhs, const Block* rhs) {
+      return lhs->offset < rhs->offset;
+    });
+
+    // find the smallest gap that fits, or append after all conflicts
+    size_t best_offset = 0, best_gap = 0, prev_end = 0;
+    bool found = false;
+    for (const Block* other : conflicts) {
+      if (other->offset > prev_end) {
+        size_t gap = other->offset - prev_end;
+        if (gap >= block.size && (!found || gap < best_gap)) {
+          found       = true;
+          best_gap    = gap;
+          best_offset = prev_end;
+        }
+      }
+      prev_end = std::max(prev_end, other->offset + other->size);
+    }
+    block.offset = found ? best_offset : prev_end;
+    arena_size_  = std::max(arena_size_, block.offset + block.size);
+    placed.push_back(idx);
+  }
+  planned_ = true;
+}
+
+size_t StaticMemoryPlanner::GetOffset(const std::string& name) const {
+  CHECK(planned_) << "Should call Plan() first";
+  CHECK(name2index_.count(name)) << "Variable [" << name << "] is not planned";
+  return blocks_[name2index_.at(name)].offset;
+}
+
+std::vector<std::string> StaticMemoryPlanner::GetReusedFrom(const std::string& name) const {
+  CHECK(planned_) << "Should call Plan() first";
+  CHECK(name2index_.count(name)) << "Variable [" << name << "] is not planned";
+  const auto& block = blocks_[name2index_.at(name)];
+  std::vector<std::string> res;
+  for (const auto& other : blocks_) {
+    if (other.last_step < block.first_step && other.offset < block.offset + block.size &&
+        block.offset < other.offset + other.size) {
+      res.push_back(other.name);
+    }
+  }
+  return res;
+}
+
+std::string StaticMemoryPlanner::Report() const {
+  std::stringstream ss;
+  ss << "StaticMemoryPlanner: " << blocks_.size() << " variables, arena size " << arena_size_
+     << " bytes, naive size " << naive_size_ << " bytes";
+  if (naive_size_ > 0) {
+    ss << ", saved " << (100.0 * (naive_size_ - arena_size_) / naive_size_) << "%";
+  }
+  return ss.str();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
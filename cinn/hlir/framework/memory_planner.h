@@ -0,0 +1,83 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * StaticMemoryPlanner packs variables into one arena offline. Each variable is alive in the closed interval
+ * [first_step, last_step] of instructions, and two variables can share memory only if their intervals do not
+ * intersect. The offsets are assigned greedily by size: larger variables are placed first, each one into the
+ * best-fit gap among the placed variables whose lifetime overlaps with it.
+ */
+class StaticMemoryPlanner {
+ public:
+  struct Block {
+    std::string name;
+    size_t size;
+    int first_step;
+    int last_step;
+    size_t offset;
+  };
+
+  explicit StaticMemoryPlanner(size_t alignment = 64);
+
+  // add a variable of `size` bytes which is alive from `first_step` to `last_step`
+  void AddVariable(const std::string& name, size_t size, int first_step, int last_step);
+
+  // assign offsets for all added variables, can't add variable anymore after call it
+  void Plan();
+
+  bool Contains(const std::string& name) const { return name2index_.count(name); }
+
+  // get the offset of a variable in the arena
+  size_t GetOffset(const std::string& name) const;
+
+  // the variables which died before `name` is alive and whose memory `name` reuses, i.e. their memory regions
+  // intersect the one of `name`
+  std::vector<std::string> GetReusedFrom(const std::string& name) const;
+
+  const std::vector<Block>& blocks() const { return blocks_; }
+
+  // the bytes of the arena holding all variables
+  size_t arena_size() const { return arena_size_; }
+
+  // the bytes if every variable had its own memory
+  size_t naive_size() const { return naive_size_; }
+
+  // a summary comparing the planned arena size with the naive sum
+  std::string Report() const;
+
+ private:
+  size_t Align(size_t size) const { return (size + alignment_ - 1) / alignment_ * alignment_; }
+
+  size_t alignment_;
+  bool planned_      = false;
+  size_t arena_size_ = 0;
+  size_t naive_size_ = 0;
+  std::vector<Block> blocks_;
+  absl::flat_hash_map<std::string, int> name2index_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
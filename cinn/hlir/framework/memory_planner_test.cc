@@ -0,0 +1,71 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(StaticMemoryPlanner, Basic) {
+  StaticMemoryPlanner planner(64);
+  planner.AddVariable("A", 100, 0, 1);
+  planner.AddVariable("B", 200, 1, 2);
+  planner.AddVariable("C", 100, 2, 3);
+  planner.AddVariable("D", 64, 3, 4);
+  planner.Plan();
+
+  // B is placed firstly as the largest one, A conflicts with B, C reuses A and D reuses B
+  ASSERT_EQ(planner.GetOffset("B"), 0UL);
+  ASSERT_EQ(planner.GetOffset("A"), 256UL);
+  ASSERT_EQ(planner.GetOffset("C"), 256UL);
+  ASSERT_EQ(planner.GetOffset("D"), 0UL);
+  ASSERT_EQ(planner.arena_size(), 384UL);
+  ASSERT_EQ(planner.naive_size(), 576UL);
+
+  auto reused_from_c = planner.GetReusedFrom("C");
+  ASSERT_EQ(reused_from_c.size(), 1UL);
+  ASSERT_EQ(reused_from_c[0], "A");
+  ASSERT_TRUE(planner.GetReusedFrom("A").empty());
+  LOG(INFO) << planner.Report();
+}
+
+TEST(StaticMemoryPlanner, NoOverlap) {
+  StaticMemoryPlanner planner(64);
+  std::vector<int> lifetimes = {0, 3, 1, 5, 2, 4, 6, 7};
+  for (int i = 0; i < lifetimes.size(); i += 2) {
+    planner.AddVariable("var_" + std::to_string(i), 64 * (i + 1), lifetimes[i], lifetimes[i + 1]);
+  }
+  planner.Plan();
+
+  // variables alive at the same time never share memory
+  const auto& blocks = planner.blocks();
+  for (int i = 0; i < blocks.size(); ++i) {
+    ASSERT_LE(blocks[i].offset + blocks[i].size, planner.arena_size());
+    for (int j = i + 1; j < blocks.size(); ++j) {
+      bool lifetime_overlap =
+          blocks[i].first_step <= blocks[j].last_step && blocks[j].first_step <= blocks[i].last_step;
+      bool memory_overlap =
+          blocks[i].offset < blocks[j].offset + blocks[j].size && blocks[j].offset < blocks[i].offset + blocks[i].size;
+      ASSERT_FALSE(lifetime_overlap && memory_overlap) << blocks[i].name << " and " << blocks[j].name;
+    }
+  }
+  ASSERT_LE(planner.arena_size(), planner.naive_size());
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
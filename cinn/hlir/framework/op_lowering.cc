@@ -70,6 +70,10 @@ OpLowerer::OpLowerer(const absl::flat_hash_map<std::string, Type>& type_dict,
                      const Target& target)
     : type_dict_(type_dict), shape_dict_(shape_dict), target_(target) {}
 
+void OpLowerer::SetSymbolicOuterDimVars(const absl::flat_hash_set<std::string>& symbolic_vars) {
+  symbolic_vars_ = symbolic_vars;
+}
+
 std::vector<ir::LoweredFunc> OpLowerer::LowerWithoutSchedule(GroupPtr& group) {
   VLOG(3) << "Lowering Group : " << group->group_id << " , Op Pattern : " << group->op_pattern_kind;
   if (FLAGS_cinn_ir_schedule) {
@@ -94,6 +98,23 @@ std::vector<ir::LoweredFunc> OpLowerer::LowerWithoutSchedule(GroupPtr& group) {
 
 std::vector<ir::LoweredFunc> OpLowerer::Lower(GroupPtr& group) {
   VLOG(3) << "Lowering Group : " << group->group_id << " , Op Pattern : " << group->op_pattern_kind;
+  if (IsSymbolicGroup(group)) {
+    CHECK(target_ == common::DefaultHostTarget()) << "Symbolic dimension only supports X86 now!";
+    switch (group->op_pattern_kind) {
+      case framework::kElemWise:
+      case framework::kBroadcast:
+      case framework::kInjective:
+        break;
+      default:
+        LOG(FATAL) << "Group " << group->group_id << " with Op Pattern " << group->op_pattern_kind
+                   << " has symbolic dimension, only Elementwise/Broadcast/Injective group supports it now!";
+    }
+    // the schedules of ops assume constant extents, so symbolic group is lowered without them.
+    if (FLAGS_cinn_ir_schedule) {
+      return IRLowerOpWithoutSchedule(&OpLowerer::IRElementwiseCompute, group);
+    }
+    return LowerOp(&OpLowerer::ElementwiseCompute, &OpLowerer::ElementwiseSchedule, group);
+  }
   if (FLAGS_cinn_ir_schedule) {
     switch (group->op_pattern_kind) {
       case framework::kElemWise:
@@ -143,6 +164,7 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerOpWithoutSchedule(IRComputeFuncti
       ast_exprs.insert(ast_exprs.end(), exprs.begin(), exprs.end());
     }
   }
+  CheckSymbolicOutputs(group, tensor_map);
   ir::ModuleExpr mod_expr(ast_exprs);
   ir::IRSchedule ir_sch(mod_expr);
   ir_sch.MergeExprs();
@@ -288,6 +310,8 @@ std::vector<ir::LoweredFunc> OpLowerer::LowerOp(ComputeFunction compute, Schedul
     }
   }
 
+  CheckSymbolicOutputs(group, tensor_map);
+
   VLOG(3) << "After Compute, Do Schedule!";
   // do schedule.
   if (group->fused_sub_groups.size() == 0) {
@@ -343,18 +367,7 @@ std::vector<ir::Tensor> OpLowerer::CollectInputTensor(std::vector<ir::Tensor>& f
     auto source_data = source->safe_as<NodeData>();
     CHECK(source_data);
     if (FLAGS_cinn_ir_schedule) {
-      auto dtype = this->type_dict_.at(source_data->id());
-      CHECK(dtype.is_supported()) << "Node " << source_data->id() << " 's dtype " << dtype << "is not supported yet!";
-      ir::Tensor tensor;
-      if (dtype == Float(32)) {
-        tensor = lang::Placeholder<float>(source_data->id(), this->shape_dict_.at(source_data->id()));
-      } else if (dtype.is_bool()) {
-        tensor = lang::Placeholder<bool>(source_data->id(), this->shape_dict_.at(source_data->id()));
-      } else if (dtype == Int(32)) {
-        tensor = lang::Placeholder<int32_t>(source_data->id(), this->shape_dict_.at(source_data->id()));
-      } else if (dtype == Int(64)) {
-        tensor = lang::Placeholder<int64_t>(source_data->id(), this->shape_dict_.at(source_data->id()));
-      }
+      auto tensor = CreatePlaceholder(source_data);
       if (!tensor_map.count(source_data->id())) {
         tensor_map[source_data->id()] = tensor;
         // record func input args
@@ -365,18 +378,7 @@ std::vector<ir::Tensor> OpLowerer::CollectInputTensor(std::vector<ir::Tensor>& f
       if (tensor_map.count(source_data->id())) {
         tensor_inputs.push_back(tensor_map[source_data->id()]);
       } else {
-        auto dtype = this->type_dict_.at(source_data->id());
-        CHECK(dtype.is_supported()) << "Node " << source_data->id() << " 's dtype " << dtype << "is not supported yet!";
-        ir::Tensor tensor;
-        if (dtype == Float(32)) {
-          tensor = lang::Placeholder<float>(source_data->id(), this->shape_dict_.at(source_data->id()));
-        } else if (dtype.is_bool()) {
-          tensor = lang::Placeholder<bool>(source_data->id(), this->shape_dict_.at(source_data->id()));
-        } else if (dtype == Int(32)) {
-          tensor = lang::Placeholder<int32_t>(source_data->id(), this->shape_dict_.at(source_data->id()));
-        } else if (dtype == Int(64)) {
-          tensor = lang::Placeholder<int64_t>(source_data->id(), this->shape_dict_.at(source_data->id()));
-        }
+        auto tensor                    = CreatePlaceholder(source_data);
         tensor_map[source_data->id()] = tensor;
         tensor_inputs.push_back(tensor);
         // record func input args
@@ -387,6 +389,75 @@ std::vector<ir::Tensor> OpLowerer::CollectInputTensor(std::vector<ir::Tensor>& f
   return tensor_inputs;
 }
 
+ir::Tensor OpLowerer::CreatePlaceholder(const NodeData* node_data) {
+  auto id    = node_data->id();
+  auto dtype = this->type_dict_.at(id);
+  CHECK(dtype.is_supported()) << "Node " << id << " 's dtype " << dtype << "is not supported yet!";
+  auto& shape = this->shape_dict_.at(id);
+  std::vector<Expr> shape_exprs;
+  for (auto dim : shape) {
+    shape_exprs.push_back(Expr(dim));
+  }
+  // the outermost extent of symbolic tensor is bound to the dims of its buffer at runtime.
+  if (symbolic_vars_.count(id)) {
+    CHECK(!shape_exprs.empty()) << "Symbolic node data " << id << " can't be a scalar!";
+    shape_exprs[0] = Expr(symbolic_dim_);
+  }
+
+  ir::Tensor tensor;
+  if (dtype == Float(32)) {
+    tensor = lang::Placeholder<float>(id, shape_exprs);
+  } else if (dtype.is_bool()) {
+    tensor = lang::Placeholder<bool>(id, shape_exprs);
+  } else if (dtype == Int(32)) {
+    tensor = lang::Placeholder<int32_t>(id, shape_exprs);
+  } else if (dtype == Int(64)) {
+    tensor = lang::Placeholder<int64_t>(id, shape_exprs);
+  }
+  return tensor;
+}
+
+bool OpLowerer::IsSymbolicGroup(const GroupPtr& group) {
+  if (symbolic_vars_.empty()) {
+    return false;
+  }
+  for (auto node : group->CollectNodes()) {
+    for (auto& link : node->inlinks()) {
+      if (symbolic_vars_.count(link->source()->id())) {
+        return true;
+      }
+    }
+    for (auto node_data : GetAllNodeData(node)) {
+      if (symbolic_vars_.count(node_data->id())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void OpLowerer::CheckSymbolicOutputs(const GroupPtr& group, std::unordered_map<std::string, ir::Tensor>& tensor_map) {
+  if (symbolic_vars_.empty()) {
+    return;
+  }
+  // the computes of some ops take the inferred out shapes, whose outermost extent is only a probe value of the
+  // symbolic dimension, such op can't be lowered with symbolic dimension.
+  for (auto node : group->CollectNodes()) {
+    auto id = GetNodeData(node)->id();
+    if (!tensor_map.count(id)) {
+      continue;
+    }
+    auto& shape = tensor_map[id]->shape;
+    for (int axis = 0; axis < shape.size(); ++axis) {
+      bool is_symbolic = symbolic_vars_.count(id) && axis == 0;
+      bool valid       = is_symbolic ? (shape[axis].as_var() && shape[axis].as_var()->name == symbolic_dim_->name)
+                                     : shape[axis].is_constant();
+      CHECK(valid) << "The compute of op " << node->op()->name << " gets shape " << utils::Join(shape, ", ")
+                   << " for " << id << ", which doesn't support symbolic dimension yet!";
+    }
+  }
+}
+
 std::vector<Expr> OpLowerer::IRElementwiseCompute(poly::StageMap& stages,
                                                   std::vector<ir::Tensor>& func_tensors,
                                                   std::unordered_map<std::string, ir::Tensor>& tensor_map,
@@ -1312,7 +1383,7 @@ void OpLowerer::ElementwiseCompute(poly::StageMap& stages,
     // do compute
     common::CINNValuePack value_pack = impl->fcompute(common::CINNValuePack{cinn_inputs});
 
-    if (group->master_nodes.count(node)) {
+    if (group->master_nodes.count(node) && !IsSymbolicGroup(group)) {
       // do shedule
       value_pack = impl->fschedule(value_pack);
     }
@@ -1331,6 +1402,15 @@ void OpLowerer::ElementwiseSchedule(poly::StageMap& stages,
                                     const GroupPtr& group,
                                     const GroupPtr& sub_group) {
   VLOG(3) << "ElementwiseSchedule Group : " << sub_group->group_id;
+  if (IsSymbolicGroup(group)) {
+    // each output keeps its own loops, as the loop transforms of master assume constant extents.
+    for (auto& node : sub_group->nodes) {
+      if (!group->output_nodes.count(node)) {
+        stages[tensor_map[GetNodeData(node)->id()]]->ComputeInline();
+      }
+    }
+    return;
+  }
   auto master_node      = *group->master_nodes.begin();
   auto master_node_data = GetNodeData(master_node);
   auto master_stage     = stages[tensor_map[master_node_data->id()]];
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_set.h>
+
 #include <string>
 #include <vector>
 
@@ -70,6 +72,9 @@ class OpLowerer {
             const Target&);
   std::vector<ir::LoweredFunc> Lower(GroupPtr& group);
   std::vector<ir::LoweredFunc> LowerWithoutSchedule(GroupPtr& group);
+  // Set the node datas whose outermost dimension is symbolic, see Graph::GetSymbolicOuterDimVars. The tensors of
+  // them are lowered with the outermost extent read from the buffer at runtime.
+  void SetSymbolicOuterDimVars(const absl::flat_hash_set<std::string>& symbolic_vars);
 
  private:
   std::vector<ir::LoweredFunc> LowerOp(ComputeFunction, ScheduleFunction, GroupPtr&);
@@ -114,11 +119,18 @@ class OpLowerer {
   std::vector<ir::Tensor> CollectInputTensor(std::vector<ir::Tensor>& func_args,
                                              std::unordered_map<std::string, ir::Tensor>& tensor_map,
                                              const Node* node);
+  ir::Tensor CreatePlaceholder(const NodeData* node_data);
+  bool IsSymbolicGroup(const GroupPtr& group);
+  void CheckSymbolicOutputs(const GroupPtr& group, std::unordered_map<std::string, ir::Tensor>& tensor_map);
 
   Target target_;
   const absl::flat_hash_map<std::string, Type>& type_dict_;
   const absl::flat_hash_map<std::string, shape_t>& shape_dict_;
 
+  absl::flat_hash_set<std::string> symbolic_vars_;
+  // the outermost extent shared by all the symbolic tensors
+  ir::Var symbolic_dim_{"symbolic_outer_dim", common::Int(32)};
+
   // fucntion name prefix
   const std::string func_name_prefix = "fn_";
 };
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <numeric>
 #include <thread>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -25,9 +26,13 @@
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/backends/nvrtc_util.h"
 #include "cinn/common/context.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/module.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_parallel_compile_share_engine);
 DECLARE_string(cinn_source_code_save_path);
 
 namespace cinn {
@@ -36,6 +41,15 @@ namespace framework {
 static constexpr int DebugLogMaxLen = 30000;
 
 std::vector<std::unique_ptr<Instruction>> ParallelCompiler::operator()() {
+  if (graph_->fusion_groups.empty()) {
+    return {};
+  }
+  // each thread compiles FLAGS_cinn_parallel_compile_size groups at least
+  int num_groups = graph_->fusion_groups.size();
+  int group_size = std::max(FLAGS_cinn_parallel_compile_size, 1);
+  num_threads_   = std::max(1, std::min<int>(std::thread::hardware_concurrency(), (num_groups - 1) / group_size + 1));
+  // lowering groups
+  LowerGroups();
   // Task Spilt
   SplitTask();
   // launch task
@@ -44,73 +58,143 @@ std::vector<std::unique_ptr<Instruction>> ParallelCompiler::operator()() {
   return MergeResult();
 }
 
-void ParallelCompiler::SplitTask() {
-  CHECK(graph_->fusion_groups.size() == optition_.lowered_funcs.size() || optition_.lowered_funcs.size() == 0);
-  // split task
-  int num_per_task = std::max((graph_->fusion_groups.size() - 1) / FLAGS_cinn_parallel_compile_size + 1, 16UL);
-
-  for (int idx = 0; idx < graph_->fusion_groups.size(); idx += num_per_task) {
-    int start          = idx;
-    int end            = std::min(idx + num_per_task, static_cast<int>(graph_->fusion_groups.size()));
-    auto groups        = std::vector<std::shared_ptr<Graph::Group>>(graph_->fusion_groups.begin() + start,
-                                                             graph_->fusion_groups.begin() + end);
-    auto lowered_funcs = optition_.lowered_funcs.size()
-                             ? std::vector<std::vector<ir::LoweredFunc>>(optition_.lowered_funcs.begin() + start,
-                                                                         optition_.lowered_funcs.begin() + end)
-                             : optition_.lowered_funcs;
-    tasks_.emplace_back(scope_, graph_, groups, lowered_funcs, target_);
+int64_t EstimateLoweringCost(const Graph::Group& group, const absl::flat_hash_map<std::string, shape_t>& shape_dict) {
+  int64_t cost     = 0;
+  auto count_nodes = [&](const std::vector<Node*>& nodes) {
+    for (auto* node : nodes) {
+      // the depth of the loop nest over the outputs
+      size_t depth = 1;
+      for (auto& link : node->outlinks()) {
+        auto* node_data = link->sink()->safe_as<NodeData>();
+        if (node_data && shape_dict.count(node_data->id())) {
+          depth = std::max(depth, shape_dict.at(node_data->id()).size());
+        }
+      }
+      cost += depth;
+    }
+  };
+  if (group.fused_sub_groups.empty()) {
+    count_nodes(group.nodes);
+  } else {
+    for (auto& sub_group : group.fused_sub_groups) {
+      count_nodes(sub_group->nodes);
+    }
   }
-  VLOG(3) << "Split task to " << tasks_.size() << " sub-task!";
+  // reductions and opaque ops are scheduled by much more complicated ways
+  if (group.op_pattern_kind == kCommReduce || group.op_pattern_kind == kOpaque) {
+    cost *= 2;
+  }
+  return cost;
 }
 
-void RunTask(ParallelCompiler::Task* task) {
-  VLOG(3) << "Stark run sub-task, Thread Id : " << std::this_thread::get_id();
-  task->Lowering();
-  task->CodegenAndJit();
-  task->BuildInstruction();
+int64_t EstimateCompilingCost(const std::vector<ir::LoweredFunc>& funcs) {
+  int64_t cost = 0;
+  for (auto& func : funcs) {
+    auto nodes = ir::CollectIRNodesWithoutTensor(func->body, [](const Expr* x) {
+      return x->As<ir::For>() || x->As<ir::PolyFor>() || x->As<ir::Store>();
+    });
+    cost += nodes.size() + 1;
+  }
+  return cost;
 }
 
-void ParallelCompiler::LaunchTask() {
-  // start sub-task.
-  std::vector<std::thread> threads;
-  for (int idx = 1; idx < tasks_.size(); ++idx) {
-    threads.emplace_back(RunTask, &tasks_[idx]);
+namespace {
+// sort the indices of jobs by their cost in descending order, so that the expensive jobs are
+// started first and the cheap ones fill the gaps at the end
+std::vector<int> SortByCost(const std::vector<int64_t>& costs) {
+  std::vector<int> order(costs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&costs](int a, int b) { return costs[a] > costs[b]; });
+  return order;
+}
+}  // namespace
+
+void ParallelCompiler::LowerGroups() {
+  auto& groups = graph_->fusion_groups;
+  CHECK(groups.size() == optition_.lowered_funcs.size() || optition_.lowered_funcs.size() == 0);
+  if (!optition_.lowered_funcs.empty()) {
+    lowered_funcs_ = optition_.lowered_funcs;
+    return;
   }
 
-  RunTask(&tasks_[0]);
-  // syncthreads.
-  for (auto& worker : threads) {
-    worker.join();
+  auto& dtype_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  std::vector<int64_t> costs;
+  for (auto& group : groups) {
+    costs.push_back(EstimateLoweringCost(*group, shape_dict));
   }
+  auto order = SortByCost(costs);
+
+  lowered_funcs_.resize(groups.size());
+  auto lower_group = [&](int index) {
+    utils::RecordEvent record_lowering("ParallelCompiler::Lowering");
+    auto& group = groups[order[index]];
+    VLOG(3) << "group_id is : " << group->group_id << ", and its number is : " << group->nodes.size()
+            << ", thread id : " << std::this_thread::get_id();
+    OpLowerer op_lowerer(dtype_dict, shape_dict, target_);
+    op_lowerer.SetSymbolicOuterDimVars(graph_->GetSymbolicOuterDimVars());
+    auto& lowered_func = lowered_funcs_[order[index]];
+    lowered_func       = op_lowerer.Lower(group);
+    CHECK_EQ(lowered_func.size(), 1) << "Lowerd Function Is Not Equal 1!";
+    VLOG(3) << lowered_func[0];
+  };
+  utils::parallel_run(lower_group, utils::SequenceDispatcher(0, groups.size()), num_threads_);
 }
 
-std::vector<std::unique_ptr<Instruction>> ParallelCompiler::MergeResult() {
-  std::vector<std::unique_ptr<Instruction>> res;
-  for (auto& task : tasks_) {
-    for (auto& instr : task.instructions) {
-      res.push_back(std::move(instr));
-    }
+void ParallelCompiler::SplitTask() {
+  // pack the groups into num_threads_ tasks, every group is assigned to the task with the least cost
+  // in the descending order of their cost, which balances the cost of tasks well
+  std::vector<int64_t> costs;
+  for (auto& funcs : lowered_funcs_) {
+    costs.push_back(EstimateCompilingCost(funcs));
+  }
+  int num_tasks = std::min<int>(num_threads_, lowered_funcs_.size());
+  if (FLAGS_cinn_parallel_compile_share_engine) {
+    backends::ExecutionOptions options;
+    options.concurrent_link = true;
+    shared_engine_          = backends::ExecutionEngine::Create(options);
   }
-  return std::move(res);
+  for (int idx = 0; idx < num_tasks; ++idx) {
+    tasks_.emplace_back(scope_, target_);
+    tasks_.back().engine = shared_engine_;
+  }
+  for (int group_id : SortByCost(costs)) {
+    auto task = std::min_element(
+        tasks_.begin(), tasks_.end(), [](const Task& a, const Task& b) { return a.cost < b.cost; });
+    task->group_ids.push_back(group_id);
+    task->lowered_funcs.push_back(lowered_funcs_[group_id]);
+    task->cost += costs[group_id];
+  }
+  // launch the expensive tasks first
+  std::stable_sort(tasks_.begin(), tasks_.end(), [](const Task& a, const Task& b) { return a.cost > b.cost; });
+  VLOG(3) << "Split task to " << tasks_.size() << " sub-task!";
 }
 
-void ParallelCompiler::Task::Lowering() {
-  if (!lowered_funcs.size()) {
-    auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
-    auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
-
-    OpLowerer op_lowerer(dtype_dict, shape_dict, target);
-    for (auto& group : groups) {
-      VLOG(3) << "group_id is : " << group->group_id << ", and its number is : " << group->nodes.size();
+void ParallelCompiler::LaunchTask() {
+  auto run_task = [this](int index) {
+    auto& task = tasks_[index];
+    VLOG(3) << "Start run sub-task " << index << " with cost " << task.cost
+            << ", Thread Id : " << std::this_thread::get_id();
+    task.CodegenAndJit();
+    task.BuildInstruction();
+  };
+  utils::parallel_run(run_task, utils::SequenceDispatcher(0, tasks_.size()), num_threads_);
+}
 
-      lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
-      CHECK_EQ(lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
-      VLOG(3) << lowered_funcs.back()[0];
+std::vector<std::unique_ptr<Instruction>> ParallelCompiler::MergeResult() {
+  // restore the instructions in the order of the groups
+  std::vector<std::unique_ptr<Instruction>> res(lowered_funcs_.size());
+  for (auto& task : tasks_) {
+    CHECK_EQ(task.group_ids.size(), task.instructions.size());
+    for (int idx = 0; idx < task.instructions.size(); ++idx) {
+      res[task.group_ids[idx]] = std::move(task.instructions[idx]);
     }
   }
+  return res;
 }
 
 void ParallelCompiler::Task::CodegenAndJit() {
+  utils::RecordEvent record_jit("ParallelCompiler::CodegenAndJit");
   // build module
   ir::Module::Builder builder(common::UniqName("module"), target);
   for (auto& func : lowered_funcs) {
@@ -159,16 +243,23 @@ void ParallelCompiler::Task::CodegenAndJit() {
       CHECK(cufunc);
       symbols.RegisterVar(fn->name + "_ptr_", reinterpret_cast<void*>(cufunc));
     }
-    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions(), std::move(symbols));
+    if (engine) {
+      engine->RegisterSymbols(std::move(symbols));
+    } else {
+      engine = backends::ExecutionEngine::Create(backends::ExecutionOptions(), std::move(symbols));
+    }
     engine->Link<backends::CodeGenCUDA_Host>(hmodule);
 #endif
   } else {
-    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions());
+    if (!engine) {
+      engine = backends::ExecutionEngine::Create(backends::ExecutionOptions());
+    }
     engine->Link<backends::CodeGenX86>(ir_module);
   }
 }
 
 void ParallelCompiler::Task::BuildInstruction() {
+  utils::RecordEvent record_build("ParallelCompiler::BuildInstruction");
   // get func args from lowered func.
   auto get_func_args = [](ir::LoweredFunc func, ir::Argument::IO io) {
     std::vector<std::string> args;
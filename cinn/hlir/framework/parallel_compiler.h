@@ -13,6 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
+
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "cinn/backends/llvm/execution_engine.h"
@@ -28,6 +32,12 @@ namespace cinn {
 namespace hlir {
 namespace framework {
 
+/**
+ * ParallelCompiler lowers and compiles the fusion groups of a graph on multiple threads. Groups are lowered one by one
+ * from a shared queue ordered by their estimated cost, so that the expensive ones start first and idle threads keep
+ * taking the rest, then the lowered functions are packed into tasks of balanced cost, each of which is compiled into
+ * one module.
+ */
 class ParallelCompiler {
  public:
   struct CompileOptions {
@@ -44,6 +54,7 @@ class ParallelCompiler {
   std::vector<std::unique_ptr<Instruction>> operator()();
 
  private:
+  void LowerGroups();
   void SplitTask();
   void LaunchTask();
   std::vector<std::unique_ptr<Instruction>> MergeResult();
@@ -51,26 +62,23 @@ class ParallelCompiler {
  public:
   struct Task {
    public:
-    Task(std::shared_ptr<Scope>& s,
-         std::shared_ptr<Graph>& g,
-         std::vector<std::shared_ptr<Graph::Group>> gg,
-         std::vector<std::vector<ir::LoweredFunc>>& f,
-         Target t)
-        : scope(s), graph(g), groups(gg), lowered_funcs(f), target(t) {}
-    void Lowering();
+    Task(std::shared_ptr<Scope>& s, Target t) : scope(s), target(t) {}
     void CodegenAndJit();
     void BuildInstruction();
 
    public:
     Target target;
     std::shared_ptr<Scope> scope;
-    std::shared_ptr<Graph> graph;
-    std::vector<std::shared_ptr<Graph::Group>> groups;
+    // the indices of the compiled groups in fusion_groups of the graph
+    std::vector<int> group_ids;
     std::vector<std::unique_ptr<Instruction>> instructions;
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
+    // the sum of the estimated cost of lowered_funcs
+    int64_t cost{0};
 
    public:
-    std::unique_ptr<backends::ExecutionEngine> engine;
+    // it may be shared by all tasks when FLAGS_cinn_parallel_compile_share_engine is set
+    std::shared_ptr<backends::ExecutionEngine> engine;
 #ifdef CINN_WITH_CUDA
     std::unique_ptr<runtime::cuda::CUDAModule> cumodule;
 #endif
@@ -82,8 +90,20 @@ class ParallelCompiler {
   CompileOptions optition_;
   std::shared_ptr<Scope> scope_;
   std::shared_ptr<Graph> graph_;
+  // the number of threads to lower and compile the groups
+  int num_threads_{1};
+  // the lowered functions of each group in fusion_groups of the graph
+  std::vector<std::vector<ir::LoweredFunc>> lowered_funcs_;
+  // the engine all tasks link their modules into, it is null if each task creates its own
+  std::shared_ptr<backends::ExecutionEngine> shared_engine_;
 };
 
+// Estimate the cost to lower a group roughly, which grows with its nodes and the loop nests over their outputs.
+int64_t EstimateLoweringCost(const Graph::Group& group, const absl::flat_hash_map<std::string, shape_t>& shape_dict);
+
+// Estimate the cost to compile a lowered function roughly by its loops and stores.
+int64_t EstimateCompilingCost(const std::vector<ir::LoweredFunc>& funcs);
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
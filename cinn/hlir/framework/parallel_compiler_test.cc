@@ -0,0 +1,104 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/parallel_compiler.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_parallel_compile_share_engine);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+using common::Float;
+
+void RunParallelCompile(bool share_engine) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b = builder.CreateInput(Float(32), {16, 32}, "B");
+  auto c = builder.CreateInput(Float(32), {16, 32}, "C");
+  auto d = builder.CreateInput(Float(32), {16, 32, 8}, "D");
+  // independent groups of different cost
+  auto e = builder.Relu(a);
+  auto f = builder.Relu(builder.Add(b, c));
+  auto g = builder.ReduceSum(d, {2});
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = frontend::Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+  ASSERT_GT(graph->fusion_groups.size(), 1);
+
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  for (auto& group : graph->fusion_groups) {
+    ASSERT_GT(EstimateLoweringCost(*group, shape_dict), 0);
+  }
+
+  FLAGS_cinn_parallel_compile_size         = 1;
+  FLAGS_cinn_parallel_compile_share_engine = share_engine;
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program                     = gc.Build();
+  FLAGS_cinn_parallel_compile_size         = 0;
+  FLAGS_cinn_parallel_compile_share_engine = false;
+
+  // one instruction for each group in the order of groups
+  const auto& instructions = runtime_program->GetRunInstructions();
+  ASSERT_EQ(instructions.size(), graph->fusion_groups.size());
+  for (int i = 0; i < instructions.size(); ++i) {
+    ASSERT_EQ(instructions[i]->GetFnNames().front(), graph->fusion_groups[i]->GetFuncName());
+  }
+
+  for (auto& name : {"A", "B", "C", "D"}) {
+    SetRandData<float>(scope->GetTensor(name), target);
+  }
+  runtime_program->Execute();
+
+  auto host_a = GetTensorData<float>(scope->GetTensor("A"), target);
+  auto host_b = GetTensorData<float>(scope->GetTensor("B"), target);
+  auto host_c = GetTensorData<float>(scope->GetTensor("C"), target);
+  auto host_d = GetTensorData<float>(scope->GetTensor("D"), target);
+  auto host_e = GetTensorData<float>(scope->GetTensor(e->id), target);
+  auto host_f = GetTensorData<float>(scope->GetTensor(f->id), target);
+  auto host_g = GetTensorData<float>(scope->GetTensor(g->id), target);
+  for (int i = 0; i < host_a.size(); ++i) {
+    EXPECT_FLOAT_EQ(host_e[i], std::max(host_a[i], 0.f));
+    EXPECT_FLOAT_EQ(host_f[i], std::max(host_b[i] + host_c[i], 0.f));
+    float sum = 0.f;
+    for (int j = 0; j < 8; ++j) {
+      sum += host_d[i * 8 + j];
+    }
+    EXPECT_NEAR(host_g[i], sum, 1e-4);
+  }
+}
+
+TEST(ParallelCompilerTest, KeepGroupOrder) { RunParallelCompile(/*share_engine=*/false); }
+
+TEST(ParallelCompilerTest, ShareEngine) { RunParallelCompile(/*share_engine=*/true); }
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
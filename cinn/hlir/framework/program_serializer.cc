@@ -0,0 +1,210 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/program_serializer.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <llvm/Support/Host.h>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "cinn/hlir/framework/program_desc.pb.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+// bump it when the layout of ProgramDesc changes incompatibly
+constexpr int kProgramDescVersion = 1;
+
+void SaveInstruction(Instruction* instr, proto::ProgramDesc::Instruction* desc) {
+  auto fn_names = instr->GetFnNames();
+  auto in_args  = instr->GetInArgs();
+  auto out_args = instr->GetOutArgs();
+  CHECK_EQ(fn_names.size(), in_args.size());
+  CHECK_EQ(fn_names.size(), out_args.size());
+
+  desc->set_function_name(instr->function_name());
+  for (int i = 0; i < fn_names.size(); ++i) {
+    CHECK(fn_names[i].find("malloc_buffer_instruction") == std::string::npos &&
+          fn_names[i].find("free_buffer_instruction") == std::string::npos)
+        << "The buffer handle instructions can not be saved, please build the program without them";
+    auto* func = desc->add_functions();
+    func->set_name(fn_names[i]);
+    for (auto& arg : in_args[i]) {
+      func->add_in_args(arg);
+    }
+    for (auto& arg : out_args[i]) {
+      func->add_out_args(arg);
+    }
+  }
+  for (auto attr : instr->attrs) {
+    desc->add_attrs(attr);
+  }
+  for (auto& attr : instr->str_attrs) {
+    desc->add_str_attrs(attr);
+  }
+  desc->set_pre_run(instr->pre_run);
+}
+
+std::unique_ptr<Instruction> LoadInstruction(const proto::ProgramDesc::Instruction& desc,
+                                             const Target& target,
+                                             Scope* scope,
+                                             backends::Compiler* compiler) {
+  auto instr = std::make_unique<Instruction>(
+      target, scope, std::vector<std::string>{}, std::vector<std::string>{}, desc.function_name());
+  instr->ClearInArgs();
+  instr->ClearOutArgs();
+  for (auto& func : desc.functions()) {
+    auto* fn_ptr = compiler->Lookup(func.name());
+    CHECK(fn_ptr) << "Can't find function " << func.name() << " in the saved object code";
+    instr->SetLoweredFunc(fn_ptr, func.name());
+    instr->AddInArgs(std::vector<std::string>(func.in_args().begin(), func.in_args().end()));
+    instr->AddOutArgs(std::vector<std::string>(func.out_args().begin(), func.out_args().end()));
+  }
+  instr->attrs.assign(desc.attrs().begin(), desc.attrs().end());
+  instr->str_attrs.assign(desc.str_attrs().begin(), desc.str_attrs().end());
+  instr->pre_run = desc.pre_run();
+  instr->Finalize();
+  return instr;
+}
+
+}  // namespace
+
+void SaveProgram(GraphCompiler* graph_compiler, Program* program, const std::string& path) {
+  proto::ProgramDesc desc;
+  desc.set_version(kProgramDescVersion);
+  desc.set_target_arch(static_cast<int>(Target::Arch::X86));
+  desc.set_target_bits(static_cast<int>(common::DefaultHostTarget().bits));
+  desc.set_host_cpu(llvm::sys::getHostCPUName().str());
+  desc.set_object_code(graph_compiler->GetObjectCode());
+
+  const auto& scope = graph_compiler->GetScope();
+  absl::flat_hash_map<Buffer*, int> buffer_ids;
+  for (auto& name_view : scope->var_names()) {
+    std::string name(name_view.data(), name_view.size());
+    auto tensor = scope->GetTensor(name);
+    auto* var   = desc.add_variables();
+    var->set_name(name);
+    for (auto dim : tensor->shape().data()) {
+      var->add_shape(dim);
+    }
+    auto* dtype = var->mutable_dtype();
+    dtype->set_type(static_cast<int>(tensor->type().type()));
+    dtype->set_bits(tensor->type().bits());
+    dtype->set_lanes(tensor->type().lanes());
+    auto buffer = tensor->get_buffer();
+    var->set_buffer_id(buffer_ids.emplace(buffer.get(), buffer_ids.size()).first->second);
+    var->set_instantiated(buffer->data()->memory != nullptr);
+  }
+
+  for (auto* instrs : {&program->GetPreRunInstructions(), &program->GetRunInstructions()}) {
+    for (auto& instr : *instrs) {
+      CHECK(instr->target_.arch == Target::Arch::X86) << "Only the program running on X86 can be saved";
+      SaveInstruction(instr.get(), desc.add_instructions());
+    }
+  }
+
+  auto symbolic_vars = program->GetSymbolicOuterDimVars();
+  std::vector<std::string> sorted_symbolic_vars(symbolic_vars.begin(), symbolic_vars.end());
+  std::sort(sorted_symbolic_vars.begin(), sorted_symbolic_vars.end());
+  for (auto& name : sorted_symbolic_vars) {
+    desc.add_symbolic_outer_dim_vars(name);
+  }
+
+  std::vector<std::string> reusing_vars;
+  for (auto& item : program->GetMemoryReuse()) {
+    reusing_vars.push_back(item.first);
+  }
+  std::sort(reusing_vars.begin(), reusing_vars.end());
+  for (auto& name : reusing_vars) {
+    auto* reuse = desc.add_memory_reuses();
+    reuse->set_name(name);
+    for (auto& prev_var : program->GetMemoryReuse().at(name)) {
+      reuse->add_reused_from(prev_var);
+    }
+  }
+
+  std::ofstream of(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  CHECK(of.is_open()) << "Failed to open " << path;
+  CHECK(desc.SerializeToOstream(&of)) << "Failed to save the program to " << path;
+  VLOG(3) << "Save a program of " << desc.instructions_size() << " instructions and " << desc.variables_size()
+          << " variables to " << path;
+}
+
+LoadedProgram LoadProgram(const std::string& path, const Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "Only the program running on X86 can be loaded";
+  proto::ProgramDesc desc;
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  CHECK(ifs.is_open()) << "Failed to open " << path;
+  CHECK(desc.ParseFromIstream(&ifs)) << "Failed to parse the program saved in " << path;
+  CHECK_EQ(desc.version(), kProgramDescVersion) << "The program is saved by an incompatible version";
+  CHECK_EQ(desc.target_arch(), static_cast<int>(target.arch)) << "The program is saved for another target";
+  auto host_cpu = llvm::sys::getHostCPUName().str();
+  if (desc.host_cpu() != host_cpu) {
+    LOG(WARNING) << "The program is compiled for cpu " << desc.host_cpu() << " but loaded on " << host_cpu
+                 << ", it may use instructions not supported here";
+  }
+
+  LoadedProgram result;
+  result.compiler = backends::Compiler::Create(target);
+  result.compiler->LinkObject(desc.object_code());
+
+  result.scope = std::make_shared<Scope>();
+  absl::flat_hash_map<int, std::shared_ptr<Buffer>> buffers;
+  for (auto& var : desc.variables()) {
+    auto& tensor = absl::get<Tensor>(*result.scope->Var<Tensor>(var.name()));
+    tensor->Resize(Shape(std::vector<Shape::dim_t>(var.shape().begin(), var.shape().end())));
+    tensor->set_type(common::Type(static_cast<common::Type::type_t>(var.dtype().type()),
+                                  var.dtype().bits(),
+                                  var.dtype().lanes()));
+    auto it = buffers.find(var.buffer_id());
+    if (it != buffers.end()) {
+      tensor->set_buffer(it->second);
+      continue;
+    }
+    if (var.instantiated()) {
+      tensor->mutable_data(target, tensor->type());
+    }
+    buffers.emplace(var.buffer_id(), tensor->get_buffer());
+  }
+
+  std::vector<std::unique_ptr<Instruction>> instructions;
+  for (auto& instr_desc : desc.instructions()) {
+    instructions.emplace_back(LoadInstruction(instr_desc, target, result.scope.get(), result.compiler.get()));
+  }
+  result.runtime_program = std::make_unique<Program>(result.scope, std::move(instructions));
+  if (desc.memory_reuses_size() > 0) {
+    absl::flat_hash_map<std::string, std::vector<std::string>> reused_from;
+    for (auto& reuse : desc.memory_reuses()) {
+      reused_from.emplace(reuse.name(),
+                          std::vector<std::string>(reuse.reused_from().begin(), reuse.reused_from().end()));
+    }
+    result.runtime_program->SetMemoryReuse(std::move(reused_from));
+  }
+  result.runtime_program->SetSymbolicOuterDimVars(
+      absl::flat_hash_set<std::string>(desc.symbolic_outer_dim_vars().begin(), desc.symbolic_outer_dim_vars().end()));
+  VLOG(3) << "Load a program of " << desc.instructions_size() << " instructions and " << desc.variables_size()
+          << " variables from " << path;
+  return result;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
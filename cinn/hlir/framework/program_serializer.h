@@ -0,0 +1,51 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "cinn/backends/compiler.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * Save the runtime program built by \p graph_compiler into \p path, including the object code of the compiled
+ * functions, the instructions with their argument names and the metadata of the variables in the scope. The values of
+ * variables are not saved, so the weights should be fed into the scope of the loaded program.
+ */
+void SaveProgram(GraphCompiler* graph_compiler, Program* program, const std::string& path);
+
+//! The runtime program loaded by LoadProgram.
+struct LoadedProgram {
+  // hold the linked functions called by the instructions
+  std::unique_ptr<backends::Compiler> compiler;
+  std::shared_ptr<Scope> scope;
+  std::unique_ptr<Program> runtime_program;
+};
+
+/**
+ * Load the program saved by SaveProgram into a new scope, the functions are linked from the saved object code without
+ * lowering or codegen.
+ */
+LoadedProgram LoadProgram(const std::string& path, const Target& target);
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,183 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/program_serializer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+DECLARE_int32(cinn_program_executor_threads);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(ProgramSerializer, SaveAndLoad) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.reshape(c, {32, 100});
+  auto e   = prog.relu(d);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  std::string path = "./program_serializer_test.cinn";
+  SaveProgram(&gc, program.get(), path);
+  auto loaded = LoadProgram(path, target);
+  std::remove(path.c_str());
+
+  ASSERT_EQ(loaded.runtime_program->size(), program->size());
+  for (auto& name_view : scope->var_names()) {
+    std::string name(name_view.data(), name_view.size());
+    auto tensor        = scope->GetTensor(name);
+    auto loaded_tensor = loaded.scope->GetTensor(name);
+    ASSERT_EQ(tensor->shape().data(), loaded_tensor->shape().data());
+    ASSERT_EQ(tensor->type(), loaded_tensor->type());
+  }
+  // the output of reshape still shares buffer with its input
+  ASSERT_EQ(loaded.scope->GetTensor(c->id)->buffer()->memory, loaded.scope->GetTensor(d->id)->buffer()->memory);
+
+  auto A_data = loaded.scope->GetTensor("A")->mutable_data<float>(target);
+  auto B_data = loaded.scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+    B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+  }
+  loaded.runtime_program->Execute();
+
+  auto E_data = loaded.scope->GetTensor(e->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    ASSERT_NEAR(std::max(A_data[i] + B_data[i], 0.f), E_data[i], 1e-5);
+  }
+}
+
+TEST(ProgramSerializer, InplaceOutputsInParallel) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto e   = prog.multiply(c, b);
+  auto d   = prog.relu(c);
+  auto g   = prog.add(d, e);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.with_inplace_outputs       = true;
+  auto result                        = gc.Build(options, {g->id});
+  // relu writes into the buffer of its input, which is still read by multiply
+  ASSERT_EQ(scope->GetTensor(d->id)->get_buffer(), scope->GetTensor(c->id)->get_buffer());
+  ASSERT_FALSE(result.runtime_program->GetMemoryReuse().empty());
+
+  std::string path = "./program_serializer_inplace_test.cinn";
+  SaveProgram(&gc, result.runtime_program.get(), path);
+  auto loaded = LoadProgram(path, target);
+  std::remove(path.c_str());
+  ASSERT_EQ(loaded.runtime_program->GetMemoryReuse(), result.runtime_program->GetMemoryReuse());
+  ASSERT_EQ(loaded.scope->GetTensor(d->id)->get_buffer(), loaded.scope->GetTensor(c->id)->get_buffer());
+
+  auto A_data = loaded.scope->GetTensor("A")->mutable_data<float>(target);
+  auto B_data = loaded.scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+    B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+  }
+  // the multiply runs before the relu overwrites their shared input
+  FLAGS_cinn_program_executor_threads = 4;
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    loaded.runtime_program->Execute();
+    auto G_data = loaded.scope->GetTensor(g->id)->data<float>();
+    for (int i = 0; i < 100 * 32; i++) {
+      float sum = A_data[i] + B_data[i];
+      ASSERT_NEAR(std::max(sum, 0.f) + sum * B_data[i], G_data[i], 1e-5);
+    }
+  }
+  FLAGS_cinn_program_executor_threads = 0;
+}
+
+TEST(ProgramSerializer, SymbolicOuterDim) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {Graph::kSymbolicDim, 16}, "A");
+  auto b = builder.CreateInput(Float(32), {Graph::kSymbolicDim, 16}, "B");
+  auto c = builder.Relu(builder.Add(a, b));
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(builder.Build(), target);
+  ApplyPass(graph.get(), "InferShape");
+  ApplyPass(graph.get(), "OpFusionPass");
+  ApplyPass(graph.get(), "FusionMergePass");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto result                        = gc.Build(options, {c->id});
+
+  std::string path = "./program_serializer_symbolic_test.cinn";
+  SaveProgram(&gc, result.runtime_program.get(), path);
+  auto loaded = LoadProgram(path, target);
+  std::remove(path.c_str());
+  ASSERT_EQ(loaded.runtime_program->GetSymbolicOuterDimVars(), result.runtime_program->GetSymbolicOuterDimVars());
+
+  // the output is resized to the fed extent, which is larger than the one saved with the variables
+  int extent = loaded.scope->GetTensor(c->id)->shape().data()[0] * 4;
+  for (auto& name : {"A", "B"}) {
+    auto tensor = loaded.scope->GetTensor(name);
+    tensor->Resize(Shape({extent, 16}));
+    SetRandData<float>(tensor, target);
+  }
+  loaded.runtime_program->Execute();
+
+  auto out = loaded.scope->GetTensor(c->id);
+  ASSERT_EQ(out->shape().data(), std::vector<int>({extent, 16}));
+  auto host_a   = GetTensorData<float>(loaded.scope->GetTensor("A"), target);
+  auto host_b   = GetTensorData<float>(loaded.scope->GetTensor("B"), target);
+  auto host_out = GetTensorData<float>(out, target);
+  ASSERT_EQ(host_out.size(), extent * 16);
+  for (int i = 0; i < host_out.size(); i++) {
+    ASSERT_FLOAT_EQ(host_out[i], std::max(host_a[i] + host_b[i], 0.f));
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
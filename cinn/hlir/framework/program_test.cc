@@ -14,16 +14,30 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
 
+DECLARE_int32(cinn_program_executor_threads);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+namespace {
+
+void FailingKernel(void* args, int32_t num_args) { throw std::runtime_error("kernel failed"); }
+
+void SlowKernel(void* args, int32_t num_args) { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
+
+}  // namespace
+
 TEST(Program, ExecuteWithRawArgs) {
   // build fronted program
   frontend::Program prog;
@@ -79,6 +93,273 @@ TEST(Program, ExecuteWithRawArgs) {
   }
 }
 
+TEST(Program, ExecuteInParallel) {
+  // two independent branches joined by the last add
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.multiply(a, b);
+  auto e   = prog.relu(c);
+  auto f   = prog.add(d, a);
+  auto g   = prog.add(e, f);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  auto A_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto B_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+    B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+  }
+
+  FLAGS_cinn_program_executor_threads = 4;
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    program->Execute();
+    auto G_data = scope->GetTensor(g->id)->data<float>();
+    for (int i = 0; i < 100 * 32; i++) {
+      float expect = std::max(A_data[i] + B_data[i], 0.f) + A_data[i] * B_data[i] + A_data[i];
+      ASSERT_NEAR(expect, G_data[i], 1e-5);
+    }
+  }
+  FLAGS_cinn_program_executor_threads = 0;
+}
+
+TEST(Program, ExecuteInParallelWithError) {
+  Target target = common::DefaultHostTarget();
+  auto scope    = std::make_shared<Scope>();
+  for (auto& name : {"A", "B", "C", "D"}) {
+    auto& tensor = absl::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(Shape({4}));
+    tensor->mutable_data<float>(target);
+  }
+  // the last instruction waits for the failed one, whose error is rethrown instead of hanging the other executors
+  auto make_instr = [&](std::vector<std::string> in_args, std::string out_arg, void* fn_ptr) {
+    auto instr = std::make_unique<Instruction>(target, scope.get(), in_args, std::vector<std::string>{out_arg});
+    instr->SetLoweredFunc(fn_ptr, "fn_" + out_arg);
+    instr->Finalize();
+    return instr;
+  };
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  instrs.emplace_back(make_instr({"A"}, "B", reinterpret_cast<void*>(&FailingKernel)));
+  instrs.emplace_back(make_instr({"A"}, "C", reinterpret_cast<void*>(&SlowKernel)));
+  instrs.emplace_back(make_instr({"B", "C"}, "D", reinterpret_cast<void*>(&SlowKernel)));
+  Program program(scope, std::move(instrs));
+
+  FLAGS_cinn_program_executor_threads = 4;
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    ASSERT_THROW(program.Execute(), std::runtime_error);
+  }
+  FLAGS_cinn_program_executor_threads = 0;
+}
+
+TEST(Program, ExecuteWithStaticMemoryPlan) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  auto e   = prog.add(d, b);
+  auto f   = prog.relu(e);
+  auto g   = prog.add(f, a);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.with_static_memory_plan    = true;
+  auto result                        = gc.Build(options, {g->id});
+  ASSERT_FALSE(result.memory_plan_report.empty());
+  LOG(INFO) << result.memory_plan_report;
+
+  // intermediate variables share the arena, while feeds and fetches own their memory
+  ASSERT_TRUE(scope->GetTensor(c->id)->get_buffer()->is_external_memory());
+  ASSERT_FALSE(scope->GetTensor("A")->get_buffer()->is_external_memory());
+  ASSERT_FALSE(scope->GetTensor(g->id)->get_buffer()->is_external_memory());
+
+  auto A_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto B_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+    B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+  }
+  result.runtime_program->Execute();
+
+  auto G_data = scope->GetTensor(g->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    float expect = std::max(std::max(A_data[i] + B_data[i], 0.f) + B_data[i], 0.f) + A_data[i];
+    ASSERT_NEAR(expect, G_data[i], 1e-5);
+  }
+}
+
+TEST(Program, InplaceOutputs) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  auto e   = prog.add(d, b);
+  auto f   = prog.relu(e);
+  auto g   = prog.add(f, a);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.with_inplace_outputs       = true;
+  auto result                        = gc.Build(options, {g->id});
+
+  // the whole activation chain is written into the buffer of the first intermediate variable,
+  // while feeds are never overwritten
+  auto buffer = scope->GetTensor(c->id)->get_buffer();
+  ASSERT_EQ(scope->GetTensor(d->id)->get_buffer(), buffer);
+  ASSERT_EQ(scope->GetTensor(e->id)->get_buffer(), buffer);
+  ASSERT_EQ(scope->GetTensor(f->id)->get_buffer(), buffer);
+  ASSERT_EQ(scope->GetTensor(g->id)->get_buffer(), buffer);
+  ASSERT_NE(scope->GetTensor("A")->get_buffer(), buffer);
+  ASSERT_NE(scope->GetTensor("B")->get_buffer(), buffer);
+
+  auto A_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto B_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+    B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+  }
+  result.runtime_program->Execute();
+
+  auto G_data = scope->GetTensor(g->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    float expect = std::max(std::max(A_data[i] + B_data[i], 0.f) + B_data[i], 0.f) + A_data[i];
+    ASSERT_NEAR(expect, G_data[i], 1e-5);
+  }
+}
+
+TEST(Program, ExecuteWithContexts) {
+  // A is fed by each request while B is a weight shared by all requests
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  auto e   = prog.multiply(d, b);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  auto B_data = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+  }
+
+  const int num_requests = 4;
+  std::vector<std::unique_ptr<ExecutionContext>> contexts;
+  for (int k = 0; k < num_requests; ++k) {
+    contexts.emplace_back(program->CreateExecutionContext({"A"}));
+    auto& context = contexts.back();
+    ASSERT_FALSE(context->IsPrivate("B"));
+    ASSERT_EQ(context->GetTensor("B")->buffer(), scope->GetTensor("B")->buffer());
+    ASSERT_TRUE(context->IsPrivate("A"));
+    ASSERT_TRUE(context->IsPrivate(e->id));
+    ASSERT_NE(context->GetTensor(e->id)->buffer(), scope->GetTensor(e->id)->buffer());
+
+    auto A_data = context->GetTensor("A")->mutable_data<float>(target);
+    for (int i = 0; i < 100 * 32; i++) {
+      A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f + k;  // NOLINT
+    }
+  }
+
+  std::vector<std::thread> threads;
+  for (int k = 0; k < num_requests; ++k) {
+    threads.emplace_back([&program, &contexts, k] {
+      for (int repeat = 0; repeat < 10; ++repeat) {
+        program->Execute(contexts[k].get());
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  for (auto& context : contexts) {
+    auto A_data = context->GetTensor("A")->data<float>();
+    auto E_data = context->GetTensor(e->id)->data<float>();
+    for (int i = 0; i < 100 * 32; i++) {
+      ASSERT_NEAR(std::max(A_data[i] + B_data[i], 0.f) * B_data[i], E_data[i], 1e-5);
+    }
+  }
+}
+
+TEST(Program, ExecuteWithLaunchPlan) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.reshape(c, {32, 100});
+  auto e   = prog.relu(d);
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  auto A_data = scope->GetTensor("A")->mutable_data<float>(target);
+  auto B_data = scope->GetTensor("B")->mutable_data<float>(target);
+  // the launch plan built on the first run keeps reading the updated inputs
+  for (int repeat = 0; repeat < 3; ++repeat) {
+    for (int i = 0; i < 100 * 32; i++) {
+      A_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+      B_data[i] = (rand() * 1.f) / RAND_MAX - 0.5f;  // NOLINT
+    }
+    program->Execute();
+    auto E_data = scope->GetTensor(e->id)->data<float>();
+    for (int i = 0; i < 100 * 32; i++) {
+      ASSERT_NEAR(std::max(A_data[i] + B_data[i], 0.f), E_data[i], 1e-5);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -31,6 +31,12 @@ TEST(Tensor, basic) {
   }
 }
 
+TEST(Tensor, numel_exceed_int32) {
+  _Tensor_ tensor;
+  tensor.Resize(Shape{{65536, 65536}});
+  ASSERT_EQ(tensor.shape().numel(), int64_t{1} << 32);
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -91,6 +91,10 @@ void InferShape(Node* node, dtype_dict_t& dtype_dict, shape_dict_t& shape_dict)
   }
 }
 
+// the representative extents of a symbolic outermost dimension, the shapes are inferred with both of them to find the
+// variables whose outermost dimension follows the symbolic one
+constexpr int kSymbolicDimProbes[] = {17, 19};
+
 void InferShapePass(Graph* graph) {
   auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
   auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
@@ -102,12 +106,65 @@ void InferShapePass(Graph* graph) {
     return numel;
   };
 
+  // the inputs marked by kSymbolicDim, or recorded by the previous inference
+  std::vector<std::string> symbolic_inputs;
+  const auto& prev_symbolic_vars = graph->GetSymbolicOuterDimVars();
   for (auto& n : store_nodes) {
-    auto node = n->safe_as<Node>();
-    if (node) {
-      InferShape(node, dtype_dict, shape_dict);
+    auto node_data = n->safe_as<NodeData>();
+    if (!node_data || node_data->source_node.get() || !shape_dict.count(node_data->id())) continue;
+    auto& shape = shape_dict.at(node_data->id());
+    for (int axis = 1; axis < shape.size(); ++axis) {
+      CHECK_NE(shape[axis], Graph::kSymbolicDim) << "Only the outermost dimension of " << node_data->id()
+                                                 << " can be symbolic, but its shape is [" << utils::Join(shape, ",")
+                                                 << "]";
+    }
+    if (!shape.empty() && (shape[0] == Graph::kSymbolicDim || prev_symbolic_vars.count(node_data->id()))) {
+      symbolic_inputs.push_back(node_data->id());
+    }
+  }
+
+  if (symbolic_inputs.empty()) {
+    for (auto& n : store_nodes) {
+      auto node = n->safe_as<Node>();
+      if (node) {
+        InferShape(node, dtype_dict, shape_dict);
+      }
     }
+    return;
+  }
+
+  // infer with each representative extent, and the variables whose outermost extent changes with it are symbolic
+  std::vector<shape_dict_t> probe_shape_dicts;
+  for (int probe : kSymbolicDimProbes) {
+    shape_dict_t probe_shape_dict = shape_dict;
+    for (auto& name : symbolic_inputs) {
+      probe_shape_dict[name][0] = probe;
+    }
+    for (auto& n : store_nodes) {
+      auto node = n->safe_as<Node>();
+      if (node) {
+        InferShape(node, dtype_dict, probe_shape_dict);
+      }
+    }
+    probe_shape_dicts.emplace_back(std::move(probe_shape_dict));
+  }
+
+  absl::flat_hash_set<std::string> symbolic_vars;
+  for (auto& name_shape : probe_shape_dicts[0]) {
+    auto& shape       = name_shape.second;
+    auto& other_shape = probe_shape_dicts[1].at(name_shape.first);
+    if (shape == other_shape) continue;
+    CHECK(shape.size() == other_shape.size() && shape[0] == kSymbolicDimProbes[0] &&
+          other_shape[0] == kSymbolicDimProbes[1] && std::equal(shape.begin() + 1, shape.end(), other_shape.begin() + 1))
+        << "The shape of " << name_shape.first << " depends on the symbolic dimension except the outermost one, it is ["
+        << utils::Join(shape, ",") << "] and [" << utils::Join(other_shape, ",")
+        << "] when the symbolic dimension is " << kSymbolicDimProbes[0] << " and " << kSymbolicDimProbes[1];
+    symbolic_vars.insert(name_shape.first);
   }
+  VLOG(3) << symbolic_vars.size() << " variables have the symbolic outermost dimension";
+  // keep the shapes inferred with the first representative extent
+  shape_dict                             = std::move(probe_shape_dicts[0]);
+  graph->attrs["symbolic_outer_dim_vars"] = std::make_shared<absl::any>(std::move(symbolic_vars));
 }
 
 }  // namespace pass
@@ -367,6 +367,8 @@ Expr Store::index() const {
   CHECK(tensor_n);
   VLOG(3) << "Begin Store::index IndiceToAbsOffset";
   Expr res = common::IndiceToAbsOffset(tensor_n->shape, indices);
+  // the 64-bit offset of large buffers is kept as built, since the simplifier folds constants in int32
+  if (res.type() == Int(64)) return res;
   VLOG(3) << "Begin Store::index Simplify";
   optim::Simplify(&res);
   return res;
@@ -579,6 +581,7 @@ Expr Load::index() const {
     CHECK(tensor_n);
     VLOG(3) << "Begin Load::index IndiceToAbsOffset";
     Expr res = common::IndiceToAbsOffset(tensor_n->shape, indices);
+    if (res.type() == Int(64)) return res;
     VLOG(3) << "Begin Load::index Simplify";
     optim::Simplify(&res);
     return res;
@@ -648,6 +648,23 @@ struct BindInfo {
   }
 };
 
+//! How the iterations of a parallel loop are dealt to the tasks of a parallel launch.
+enum class ParallelSchedule : int {
+  Static  = 0,  //! Split the iterations into equal parts ahead of time.
+  Dynamic = 1,  //! Tasks fetch chunks of grain_size iterations from a shared counter.
+  Guided  = 2,  //! Like Dynamic, but the chunks shrink with the remaining iterations down to grain_size.
+};
+
+struct ParallelInfo {
+  ParallelInfo() = default;
+  ParallelInfo(ParallelSchedule schedule, int grain_size) : schedule(schedule), grain_size(grain_size) {}
+
+  ParallelSchedule schedule{ParallelSchedule::Static};
+  int grain_size{1};
+
+  inline bool is_dynamic() const { return schedule != ParallelSchedule::Static; }
+};
+
 struct ForBase {
   ForType for_type() const { return for_type_; }
   void set_for_type(ForType x) { for_type_ = x; }
@@ -660,8 +677,10 @@ struct ForBase {
     if (x.valid()) set_binded(x.for_type);
     bind_info_ = x;
   }
+  void set_parallel_info(const ParallelInfo& x) { parallel_info_ = x; }
   const VectorizeInfo& vectorize_info() const { return vectorize_info_; }
   const BindInfo& bind_info() const { return bind_info_; }
+  const ParallelInfo& parallel_info() const { return parallel_info_; }
 
   void reset_vectorize_info() {
     set_vectorized(false);
@@ -717,6 +736,7 @@ struct ForBase {
   ForType for_type_{ForType::Serial};
   VectorizeInfo vectorize_info_;
   BindInfo bind_info_;
+  ParallelInfo parallel_info_;
 };
 
 /// LLVM loop unroll metadata infomation
@@ -994,6 +1014,12 @@ namespace attr {
 // max permitted steps for auto_unroll, used in unroll_loop pass
 constexpr const char* auto_unroll_max_step = "auto_unroll_max_step";
 
+// schedule policy of the parallel loops enclosing or inside a block, static, dynamic or guided,
+// used in parallel_schedule pass
+constexpr const char* parallel_schedule = "parallel_schedule";
+// minimal number of iterations fetched at a time by dynamic or guided parallel loops, used in parallel_schedule pass
+constexpr const char* parallel_grain_size = "parallel_grain_size";
+
 }  // namespace attr
 
 }  // namespace ir
@@ -325,6 +325,32 @@ void _LoweredFunc_::PrepareArgumentExprs() {
     CHECK(let_expr.type().valid());
     argument_prepare_exprs.push_back(let_expr);
   }
+
+  /*
+   * Bind the symbolic dimensions not passed in as arguments to the extents of the first buffer having them, such as
+   *
+   * int N = cinn_buffer_get_dim(_A, 0);
+   */
+  std::set<std::string> bound_vars;
+  for (auto& arg : args) {
+    if (arg.is_var()) {
+      bound_vars.insert(arg.name());
+    }
+  }
+  for (auto& arg : args) {
+    if (!arg.is_buffer()) continue;
+    auto& shape = arg.buffer_arg()->shape;
+    for (int axis = 0; axis < shape.size(); ++axis) {
+      auto* dim_var = shape[axis].As<_Var_>();
+      if (!dim_var || bound_vars.count(dim_var->name)) continue;
+      bound_vars.insert(dim_var->name);
+      auto buffer_type = (arg.is_input() ? const_buffer_ptr_type : buffer_ptr_type);
+      Expr extent      = runtime::IntrinsicCall(
+          Int(32), runtime::intrinsic::buffer_get_dim, {Var(arg.name(), buffer_type), common::make_const(axis)});
+      argument_prepare_exprs.push_back(
+          Let::Make(Var(dim_var->name, dim_var->type()), common::CastIfNeeded(extent, dim_var->type())));
+    }
+  }
 }
 
 std::vector<Tensor> _LoweredFunc_::CollectAllTensorReference(bool with_expr_gen_tensor) const {
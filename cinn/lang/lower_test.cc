@@ -19,6 +19,7 @@
 #include <set>
 
 #include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/lang/buffer.h"
 #include "cinn/lang/compute.h"
 #include "cinn/lang/placeholder.h"
@@ -151,5 +152,31 @@ TEST(lower, temp_buffer_collects) {
   }
 }
 
+TEST(lower, int64_offset) {
+  auto get_index_types = [](int M, int N) {
+    Placeholder<float> A("A", {Expr(M), Expr(N)});
+    auto B = Compute(
+        {Expr(M), Expr(N)}, [=](Var i, Var j) -> Expr { return A(i, j) + 1.f; }, "B");
+    auto stages      = CreateStages({B});
+    auto lower_funcs = Lower("cal_B", stages, {A, B});
+
+    auto loads  = ir::CollectIRNodes(lower_funcs->body, [](const Expr* x) { return x->As<ir::Load>(); });
+    auto stores = ir::CollectIRNodes(lower_funcs->body, [](const Expr* x) { return x->As<ir::Store>(); });
+    CHECK_EQ(loads.size(), 1UL);
+    CHECK_EQ(stores.size(), 1UL);
+    return std::make_pair(loads.begin()->As<ir::Load>()->index().type(),
+                          stores.begin()->As<ir::Store>()->index().type());
+  };
+
+  // 65536 * 65536 elements exceed the range of int32
+  auto large_types = get_index_types(65536, 65536);
+  EXPECT_EQ(large_types.first, Int(64));
+  EXPECT_EQ(large_types.second, Int(64));
+
+  auto small_types = get_index_types(100, 15);
+  EXPECT_EQ(small_types.first, Int(32));
+  EXPECT_EQ(small_types.second, Int(32));
+}
+
 }  // namespace lang
 }  // namespace cinn
@@ -193,8 +193,10 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
     auto min    = Visit(&op->min);
     auto body   = Visit(&op->body);
 
-    return ir::For::Make(
+    auto expr = ir::For::Make(
         op->loop_var, min, extent, op->for_type(), op->device_api, body, op->vectorize_info(), op->bind_info());
+    expr.As<ir::For>()->set_parallel_info(op->parallel_info());
+    return expr;
   }
 
   Expr Visit(const ir::PolyFor* op) override {
@@ -211,6 +213,7 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
                               body,
                               op->vectorize_info(),
                               op->bind_info());
+    expr.As<ir::PolyFor>()->set_parallel_info(op->parallel_info());
     return expr;
   }
 
@@ -29,6 +29,7 @@
 #include "cinn/optim/lower_function_call_bind_vars.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
+#include "cinn/optim/parallel_schedule.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
@@ -52,6 +53,7 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   CastSimplify(&copied);
   Simplify(&copied);
   UnrollLoop(&copied);
+  SetParallelSchedule(&copied);
   VectorizeLoops(&copied, target);
 #ifdef CINN_WITH_CUDA
   if (FLAGS_cinn_ir_schedule) ir::SetCudaAxisInfo(&copied);
@@ -79,6 +81,7 @@ ir::Module Optimize(const ir::Module& module, const Target& target) {
   auto copied = IRCopy(Expr(module));
   if (FLAGS_cinn_ir_schedule) {
     UnrollLoop(&copied);
+    SetParallelSchedule(&copied);
     VectorizeLoops(&copied, Target());
   }
   RemoveScheduleBlock(&copied);
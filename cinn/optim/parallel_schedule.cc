@@ -0,0 +1,97 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/parallel_schedule.h"
+
+#include <string>
+#include <vector>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+bool HasParallelAttrs(const ir::ScheduleBlock* block) {
+  return block->attrs.count(ir::attr::parallel_schedule) || block->attrs.count(ir::attr::parallel_grain_size);
+}
+
+ir::ParallelInfo GetParallelInfo(const ir::ScheduleBlock* block) {
+  ir::ParallelInfo info;
+  auto schedule_it = block->attrs.find(ir::attr::parallel_schedule);
+  if (schedule_it != block->attrs.end()) {
+    const std::string* schedule = absl::get_if<std::string>(&schedule_it->second);
+    CHECK(schedule) << "The attr " << ir::attr::parallel_schedule << " of block " << block->name
+                    << " should be a string";
+    if (*schedule == "static") {
+      info.schedule = ir::ParallelSchedule::Static;
+    } else if (*schedule == "dynamic") {
+      info.schedule = ir::ParallelSchedule::Dynamic;
+    } else if (*schedule == "guided") {
+      info.schedule = ir::ParallelSchedule::Guided;
+    } else {
+      LOG(FATAL) << "Unknown parallel schedule " << *schedule << " of block " << block->name
+                 << ", it should be static, dynamic or guided";
+    }
+  }
+  auto grain_it = block->attrs.find(ir::attr::parallel_grain_size);
+  if (grain_it != block->attrs.end()) {
+    const int* grain_size = absl::get_if<int>(&grain_it->second);
+    CHECK(grain_size && *grain_size > 0) << "The attr " << ir::attr::parallel_grain_size << " of block "
+                                         << block->name << " should be a positive int";
+    info.grain_size = *grain_size;
+  }
+  return info;
+}
+
+struct ParallelScheduleMutator : public ir::IRMutator<Expr*> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::ScheduleBlock* op, Expr* expr) override {
+    if (!HasParallelAttrs(op)) {
+      ir::IRMutator<>::Visit(op, expr);
+      return;
+    }
+    enclosing_blocks_.push_back(op);
+    ir::IRMutator<>::Visit(op, expr);
+    enclosing_blocks_.pop_back();
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    if (op->is_parallel()) {
+      auto annotated = ir::CollectIRNodesWithoutTensor(
+          op->body,
+          [](const Expr* x) { return x->As<ir::ScheduleBlock>() && HasParallelAttrs(x->As<ir::ScheduleBlock>()); },
+          /*uniq_target = */ true);
+      if (!annotated.empty()) {
+        expr->As<ir::For>()->set_parallel_info(GetParallelInfo(annotated.begin()->As<ir::ScheduleBlock>()));
+      } else if (!enclosing_blocks_.empty()) {
+        expr->As<ir::For>()->set_parallel_info(GetParallelInfo(enclosing_blocks_.back()));
+      }
+    }
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  std::vector<const ir::ScheduleBlock*> enclosing_blocks_;
+};
+
+}  // namespace
+
+void SetParallelSchedule(Expr* expr) { ParallelScheduleMutator()(expr); }
+
+}  // namespace optim
+}  // namespace cinn
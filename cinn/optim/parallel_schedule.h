@@ -0,0 +1,29 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Set the schedule policy of parallel loops from the ir::attr::parallel_schedule and ir::attr::parallel_grain_size
+ * attributes of ScheduleBlocks. A parallel loop takes the attributes of the first annotated block inside it, or else
+ * of the innermost annotated block enclosing it.
+ */
+void SetParallelSchedule(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
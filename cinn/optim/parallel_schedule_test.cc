@@ -0,0 +1,101 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/parallel_schedule.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/optimize.h"
+
+namespace cinn {
+namespace optim {
+
+TEST(ParallelSchedule, from_block_attrs) {
+  using namespace ir;
+
+  Expr M(100);
+  Expr N(32);
+
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * Expr(2.f); }, "B");
+
+  auto stages   = CreateStages({B});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_parallel_schedule", stages, {A, B}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  ir::ModuleExpr mod_expr({ast_expr});
+  ir::IRSchedule ir_sch(mod_expr);
+  ir_sch.Parallel(ir_sch.GetLoops("B")[0]);
+
+  // the loops are static without the attrs
+  ast_expr = ir_sch.GetModule().GetExprs().at(0);
+  SetParallelSchedule(&ast_expr);
+  auto loop = ir_sch.GetLoops("B")[0];
+  EXPECT_FALSE(loop.As<ir::For>()->parallel_info().is_dynamic());
+
+  ir_sch.Annotate(ir_sch.GetBlock("B"), ir::attr::parallel_schedule, std::string("guided"));
+  ir_sch.Annotate(ir_sch.GetBlock("B"), ir::attr::parallel_grain_size, 4);
+  ast_expr = ir_sch.GetModule().GetExprs().at(0);
+  SetParallelSchedule(&ast_expr);
+  loop = ir_sch.GetLoops("B")[0];
+  EXPECT_EQ(loop.As<ir::For>()->parallel_info().schedule, ir::ParallelSchedule::Guided);
+  EXPECT_EQ(loop.As<ir::For>()->parallel_info().grain_size, 4);
+  // the inner serial loop is untouched
+  EXPECT_FALSE(ir_sch.GetLoops("B")[1].As<ir::For>()->parallel_info().is_dynamic());
+}
+
+TEST(ParallelSchedule, optimize_with_vectorize) {
+  using namespace ir;
+
+  Expr M(100);
+  Expr N(32);
+
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * Expr(2.f); }, "B");
+
+  auto stages   = CreateStages({B});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_parallel_vectorize", stages, {A, B}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  ir::ModuleExpr mod_expr({ast_expr});
+  ir::IRSchedule ir_sch(mod_expr);
+  ir_sch.Parallel(ir_sch.GetLoops("B")[0]);
+  ir_sch.Vectorize(ir_sch.GetLoops("B")[1], 8);
+  ir_sch.Annotate(ir_sch.GetBlock("B"), ir::attr::parallel_schedule, std::string("dynamic"));
+
+  // the schedule of the parallel loop survives the vectorization following it
+  auto optimized = Optimize(ir_sch.GetModule().GetExprs().at(0), target);
+  auto ramps     = ir::CollectIRNodes(optimized, [](const Expr* x) { return x->As<ir::Ramp>(); });
+  EXPECT_FALSE(ramps.empty());
+  auto parallel_loops = ir::CollectIRNodes(
+      optimized, [](const Expr* x) { return x->As<ir::For>() && x->As<ir::For>()->is_parallel(); });
+  ASSERT_FALSE(parallel_loops.empty());
+  for (auto& loop : parallel_loops) {
+    EXPECT_EQ(loop.As<ir::For>()->parallel_info().schedule, ir::ParallelSchedule::Dynamic);
+  }
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -756,6 +756,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
                                      outer_for->device_api,
                                      inner_for_a,
                                      outer_for->vectorize_info());
+          out_for_a.As<For>()->set_parallel_info(outer_for->parallel_info());
           Var new_iterator_inner(common::UniqName(inner_for->loop_var->name + "_s"));
           Var new_iterator_outer(common::UniqName(outer_for->loop_var->name + "_s"));
 
@@ -770,6 +771,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
                                      outer_for->device_api,
                                      inner_for_b,
                                      outer_for->vectorize_info());
+          out_for_b.As<For>()->set_parallel_info(outer_for->parallel_info());
           optim::IrReplace(&out_for_b, outer_for->loop_var, Expr(new_iterator_outer));
           *expr = Block::Make({out_for_a, out_for_b});
           VLOG(2) << *expr;
@@ -36,7 +36,7 @@ int cinn_buffer_free(void* context, struct cinn_buffer_t* buf) {
   return buf->device_interface->impl->free(context, buf);
 }
 
-void* cinn_buffer_slice(struct cinn_buffer_t* buf, uint32_t offset) {
+void* cinn_buffer_slice(struct cinn_buffer_t* buf, uint64_t offset) {
   CINN_CHECK(buf);
   uint64_t offset_byte = offset * buf->type.bytes();
   CINN_CHECK_LT(offset_byte, buf->memory_size);
@@ -87,6 +87,16 @@ void* cinn_buffer_get_data_const_handle(const struct cinn_buffer_t* buf) {
   return buf->memory;
 }
 
+int cinn_buffer_get_dim(const struct cinn_buffer_t* buf, int axis) {
+  CINN_CHECKP(buf, "%s", "buffer is null");
+  CINN_CHECK(axis >= 0 && axis < buf->dimensions);
+  CINN_CHECKP(buf->dims[axis] <= INT32_MAX,
+              "the extent %lld of axis %d exceeds int32",
+              static_cast<long long>(buf->dims[axis]),  // NOLINT
+              axis);
+  return static_cast<int>(buf->dims[axis]);
+}
+
 cinn_buffer_t* cinn_buffer_new_default(int target, uint64_t memory_size, int align) {
   struct cinn_buffer_t* buf = (struct cinn_buffer_t*)malloc(sizeof(struct cinn_buffer_t));
   buf->type                 = cinn_float32_t();
@@ -136,7 +146,10 @@ struct cinn_buffer_t* cinn_buffer_t::new_(cinn_device_kind_t device,
   CINN_CHECK(shape.size() < CINN_BUFFER_MAX_DIMS);
 
   struct cinn_buffer_t* buf = (struct cinn_buffer_t*)malloc(sizeof(struct cinn_buffer_t));
-  memcpy(&(buf->dims[0]), shape.data(), shape.size() * sizeof(int));
+  for (int i = 0; i < dimensions; i++) {
+    buf->dims[i] = shape[i];
+  }
+  buf->dimensions  = dimensions;
   buf->type        = type;
   buf->device      = device;
   buf->memory      = nullptr;
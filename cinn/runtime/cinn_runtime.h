@@ -97,8 +97,8 @@ extern cinn_type_t cinn_float64_t(int num_asterisks = 0);
 // @}
 
 //! Help to define the size of a dimension, due to polyhedral representation, we no need to record the extend or
-//! min(default to 0).
-typedef int cinn_dimension_t;
+//! min(default to 0). It is 64-bit to describe buffers with more than 2^31 elements.
+typedef int64_t cinn_dimension_t;
 
 //! Help to tell the kind of the device.
 typedef enum cinn_device_kind_t {
@@ -161,6 +161,10 @@ extern int cinn_buffer_free(void* context, struct cinn_buffer_t* buf);
 extern void* cinn_buffer_get_data_handle(struct cinn_buffer_t* buf);
 extern void* cinn_buffer_get_data_const_handle(const struct cinn_buffer_t* buf);
 
+//! Get the extent of a dimension of buffer, which is read by the functions whose shapes are symbolic. The extent is
+//! narrowed to int, since the symbolic shape variables are Int(32), and it should not exceed INT32_MAX.
+extern int cinn_buffer_get_dim(const struct cinn_buffer_t* buf, int axis);
+
 //! Create a new default cinn_buffer.
 extern cinn_buffer_t* cinn_buffer_new_default(int target, uint64_t memory_size, int align = 32);
 
@@ -294,10 +298,10 @@ struct cinn_device_interface_impl_t {
 // The device implementations
 extern struct cinn_device_interface_t* cinn_x86_device_interface();
 
-inline float cinn_buffer_load_float32(struct cinn_buffer_t* buf, uint32_t index) {
+inline float cinn_buffer_load_float32(struct cinn_buffer_t* buf, uint64_t index) {
   return ((float*)buf->memory)[index];  // NOLINT
 }
-inline double cinn_buffer_load_float64(struct cinn_buffer_t* buf, uint32_t index) {
+inline double cinn_buffer_load_float64(struct cinn_buffer_t* buf, uint64_t index) {
   return ((double*)buf->memory)[index];  // NOLINT
 }
 #endif  // __cplusplus
@@ -306,7 +310,7 @@ inline double cinn_buffer_load_float64(struct cinn_buffer_t* buf, uint32_t index
 extern "C" {
 #endif
 
-CINN_ALWAYS_INLINE void* cinn_buffer_slice(struct cinn_buffer_t* buf, uint32_t offset);
+CINN_ALWAYS_INLINE void* cinn_buffer_slice(struct cinn_buffer_t* buf, uint64_t offset);
 
 #ifdef __cplusplus
 }
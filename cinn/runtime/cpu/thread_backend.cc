@@ -14,15 +14,23 @@
 
 #include "cinn/runtime/cpu/thread_backend.h"
 
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
 #include <algorithm>
 #include <vector>
 
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/thread_pool.h"
 #include "cinn/runtime/intrinsic.h"
 
-int max_concurrency() {
+DECLARE_string(cinn_parallel_launch_backend);
+
+namespace {
+
+int GetMaxConcurrency() {
   int max_concurrency = 1;
   const char* val     = getenv("CINN_NUM_THREADS");
   if (val == nullptr) {
@@ -39,23 +47,74 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
+bool UseThreadPool() {
+  if (FLAGS_cinn_parallel_launch_backend == "thread_pool") {
+    return true;
+  }
+  CHECK_EQ(FLAGS_cinn_parallel_launch_backend, "openmp") << "Unknown parallel launch backend "
+                                                         << FLAGS_cinn_parallel_launch_backend
+                                                         << ", it should be openmp or thread_pool";
+  return false;
+}
+
+}  // namespace
+
+int max_concurrency() {
+  // the environment is read once as it is called on every parallel launch
+  static const int max_concurrency = GetMaxConcurrency();
+  return max_concurrency;
+}
+
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task) {
-  int num_workers = max_concurrency();
+  // the backend is chosen on the first launch
+  static const bool use_thread_pool = UseThreadPool();
+  auto* budget = cinn::runtime::cpu::ThreadBudget::Current();
+  if (use_thread_pool) {
+    auto* pool = budget ? budget->pool() : cinn::runtime::cpu::ThreadPool::Global();
+    return pool->Launch(flambda, datas, num_task);
+  }
+  int num_workers = budget ? budget->num_threads() : max_concurrency();
   if (num_task == 0) num_task = num_workers;
-  omp_set_num_threads(num_task);
-#pragma omp parallel num_threads(num_task)
+  // the tasks beyond the workers are dealt to the threads in turn, so a launch never exceeds its budget
+  int num_threads = std::min(num_task, num_workers);
+  omp_set_num_threads(num_threads);
+#pragma omp parallel num_threads(num_threads)
   {
-    int thread_num = omp_get_thread_num();
-    (*flambda)(thread_num, num_task, datas);
+    for (int task_id = omp_get_thread_num(); task_id < num_task; task_id += num_threads) {
+      (*flambda)(task_id, num_task, datas);
+    }
   }
   return 0;
 }
 
+int cinn_backend_parallel_next_chunk(int* counter, int extent, int grain_size, int num_task, int guided, int* end) {
+  grain_size = std::max(grain_size, 1);
+  if (!guided) {
+    int begin = __atomic_fetch_add(counter, grain_size, __ATOMIC_RELAXED);
+    *end      = static_cast<int>(std::min<int64_t>(int64_t{begin} + grain_size, extent));
+    return begin;
+  }
+  int begin = __atomic_load_n(counter, __ATOMIC_RELAXED);
+  while (begin < extent) {
+    // take a share of the remaining iterations like OpenMP guided schedule
+    int remaining = extent - begin;
+    int chunk     = std::min(remaining, std::max(grain_size, (remaining + 2 * num_task - 1) / (2 * num_task)));
+    if (__atomic_compare_exchange_n(counter, &begin, begin + chunk, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      *end = begin + chunk;
+      return begin;
+    }
+  }
+  *end = extent;
+  return extent;
+}
+
 CINN_REGISTER_HELPER(cinn_backend_parallel) {
   using namespace cinn;  // NOLINT
   using backends::FunctionProto;
   auto host_target = common::DefaultHostTarget();
   backends::GlobalSymbolRegistry::Global().RegisterFn(runtime::intrinsic::parallel_launch,
                                                       reinterpret_cast<void*>(&cinn_backend_parallel_launch));
+  backends::GlobalSymbolRegistry::Global().RegisterFn(runtime::intrinsic::parallel_next_chunk,
+                                                      reinterpret_cast<void*>(&cinn_backend_parallel_next_chunk));
   return true;
 }
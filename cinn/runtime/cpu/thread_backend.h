@@ -44,4 +44,19 @@ typedef int (*FCINNParallelLambda)(int task_id, int num_task, void* datas);
  */
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task);
 
+/**
+ * @brief Fetch the next chunk of a dynamic or guided parallel loop, called by each task of the launch until the
+ * iterations are exhausted.
+ *
+ * @param counter The number of iterations taken, shared by all the tasks of the launch and initialized to 0.
+ * @param extent The number of iterations of the loop.
+ * @param grain_size The minimal number of iterations of a chunk.
+ * @param num_task The number of tasks of the launch.
+ * @param guided Whether the chunks shrink with the remaining iterations, or else they are all of grain_size.
+ * @param end Output the end of the chunk.
+ *
+ * @return The begin of the chunk, which is not less than extent if the iterations are exhausted.
+ */
+int cinn_backend_parallel_next_chunk(int* counter, int extent, int grain_size, int num_task, int guided, int* end);
+
 }  // extern "C"
@@ -0,0 +1,297 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/thread_pool.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+
+DECLARE_string(cinn_thread_pool_cpus);
+DECLARE_int32(cinn_thread_pool_spin_count);
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+// whether the current thread is running the tasks of a launch, the launches inside a task run sequentially
+thread_local bool in_pool_task = false;
+
+thread_local ThreadBudget* current_budget = nullptr;
+
+// the low bits of the generation word hold the number of participants of the launch it publishes
+constexpr int kParticipantBits      = 16;
+constexpr uint64_t kParticipantMask = (uint64_t{1} << kParticipantBits) - 1;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+#ifdef __linux__
+// restrict the thread to run on any of `cpus`, return the error code of pthread
+int SetAffinity(pthread_t thread, const std::vector<int>& cpus) {
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+  return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+}
+
+// the cpus the thread may run on, empty if they are unknown
+std::vector<int> GetAffinity(pthread_t thread) {
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  std::vector<int> cpus;
+  if (pthread_getaffinity_np(thread, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpuset)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+#endif
+
+void PinThread(std::thread* thread, int cpu) {
+#ifdef __linux__
+  int ret = SetAffinity(thread->native_handle(), {cpu});
+  if (ret != 0) {
+    LOG(WARNING) << "Failed to pin the worker of thread pool to cpu " << cpu << ", error code: " << ret;
+  }
+#else
+  LOG_FIRST_N(WARNING, 1) << "Pinning the workers of thread pool is only supported on Linux";
+#endif
+}
+
+void RunSequentially(FCINNParallelLambda flambda, void* datas, int num_task) {
+  for (int task_id = 0; task_id < num_task; ++task_id) {
+    (*flambda)(task_id, num_task, datas);
+  }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(int num_threads, const std::vector<int>& cpus, int spin_count)
+    : num_threads_(std::max(num_threads, 1)), spin_count_(std::max(spin_count, 0)) {
+  CHECK_LE(num_threads_, kParticipantMask) << "Too many threads for the thread pool";
+  // the worker i is pinned to cpus[i], and cpus[0] is left for the calling thread
+  for (int worker_id = 1; worker_id < num_threads_; ++worker_id) {
+    workers_.emplace_back([this, worker_id] { WorkerLoop(worker_id); });
+    if (!cpus.empty()) {
+      PinThread(&workers_.back(), cpus[worker_id % cpus.size()]);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  stop_.store(true);
+  {
+    std::lock_guard<std::mutex> lock(park_mtx_);
+    park_cv_.notify_all();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+ThreadPool* ThreadPool::Global() {
+  static ThreadPool pool(
+      max_concurrency(), ParseCpuList(FLAGS_cinn_thread_pool_cpus), FLAGS_cinn_thread_pool_spin_count);
+  return &pool;
+}
+
+std::vector<int> ThreadPool::ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> cpus;
+  auto parse_int = [&](const std::string& str) {
+    CHECK(!str.empty() && std::all_of(str.begin(), str.end(), [](char c) { return std::isdigit(c); }))
+        << "Invalid cpu list: " << cpu_list;
+    return std::stoi(str);
+  };
+  size_t begin = 0;
+  while (begin < cpu_list.size()) {
+    size_t end = cpu_list.find(',', begin);
+    if (end == std::string::npos) {
+      end = cpu_list.size();
+    }
+    auto range = cpu_list.substr(begin, end - begin);
+    auto dash  = range.find('-');
+    if (dash == std::string::npos) {
+      cpus.push_back(parse_int(range));
+    } else {
+      int first = parse_int(range.substr(0, dash));
+      int last  = parse_int(range.substr(dash + 1));
+      CHECK_LE(first, last) << "Invalid cpu list: " << cpu_list;
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    begin = end + 1;
+  }
+  return cpus;
+}
+
+int ThreadPool::Launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  if (num_task == 0) num_task = num_threads_;
+  if (in_pool_task || workers_.empty() || num_task == 1) {
+    RunSequentially(flambda, datas, num_task);
+    return 0;
+  }
+  std::unique_lock<std::mutex> lock(launch_mtx_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // the pool is busy with the launch of another thread, which has taken all the cores already
+    RunSequentially(flambda, datas, num_task);
+    return 0;
+  }
+
+  int num_participants = std::min(num_task, num_threads_);
+  flambda_             = flambda;
+  datas_               = datas;
+  num_task_            = num_task;
+  num_pending_.store(num_participants - 1, std::memory_order_relaxed);
+  uint64_t counter = (generation_.load(std::memory_order_relaxed) >> kParticipantBits) + 1;
+  generation_.store((counter << kParticipantBits) | num_participants);
+  if (num_parked_.load() > 0) {
+    std::lock_guard<std::mutex> park_lock(park_mtx_);
+    park_cv_.notify_all();
+  }
+
+  in_pool_task = true;
+  RunTasks(0, num_participants);
+  in_pool_task = false;
+  while (num_pending_.load(std::memory_order_acquire) > 0) {
+    CpuRelax();
+  }
+  return 0;
+}
+
+void ThreadPool::RunTasks(int worker_id, int num_participants) {
+  for (int task_id = worker_id; task_id < num_task_; task_id += num_participants) {
+    (*flambda_)(task_id, num_task_, datas_);
+  }
+}
+
+void ThreadPool::WorkerLoop(int worker_id) {
+  in_pool_task  = true;
+  uint64_t seen = 0;
+  while (true) {
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    for (int spin = 0; generation == seen && spin < spin_count_; ++spin) {
+      CpuRelax();
+      generation = generation_.load(std::memory_order_acquire);
+    }
+    if (generation == seen) {
+      std::unique_lock<std::mutex> lock(park_mtx_);
+      num_parked_.fetch_add(1);
+      park_cv_.wait(lock, [&] { return stop_.load() || generation_.load() != seen; });
+      num_parked_.fetch_sub(1);
+      generation = generation_.load(std::memory_order_acquire);
+    }
+    if (stop_.load()) {
+      return;
+    }
+    seen = generation;
+    // the launcher waits for all the participants, so the launch stays unchanged while running its tasks
+    int num_participants = generation & kParticipantMask;
+    if (worker_id < num_participants) {
+      RunTasks(worker_id, num_participants);
+      num_pending_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+}
+
+ThreadBudget::ThreadBudget(int num_threads, const std::vector<int>& cpus)
+    : num_threads_(num_threads > 0 ? num_threads : static_cast<int>(cpus.size())), cpus_(cpus) {
+  CHECK_GT(num_threads_, 0) << "The thread budget should have at least one thread";
+}
+
+ThreadPool* ThreadBudget::pool() {
+  std::call_once(pool_flag_, [this] {
+    pool_ = std::make_unique<ThreadPool>(num_threads_, cpus_, FLAGS_cinn_thread_pool_spin_count);
+  });
+  return pool_.get();
+}
+
+const std::vector<std::unique_ptr<ThreadBudget>>& ThreadBudget::Partition(int num_parts) {
+  CHECK(num_parts > 0 && num_parts <= num_threads_)
+      << "Can't split a thread budget of " << num_threads_ << " threads into " << num_parts << " parts";
+  std::lock_guard<std::mutex> lock(partition_mtx_);
+  auto& parts = partitions_[num_parts];
+  if (!parts.empty()) {
+    return parts;
+  }
+  // the remainders of the threads and the cpus are given to the first parts
+  int num_cpus  = cpus_.size();
+  int cpu_begin = 0;
+  for (int i = 0; i < num_parts; ++i) {
+    int part_threads = num_threads_ / num_parts + (i < num_threads_ % num_parts ? 1 : 0);
+    std::vector<int> part_cpus;
+    if (num_cpus >= num_parts) {
+      int cpu_end = cpu_begin + num_cpus / num_parts + (i < num_cpus % num_parts ? 1 : 0);
+      part_cpus.assign(cpus_.begin() + cpu_begin, cpus_.begin() + cpu_end);
+      cpu_begin = cpu_end;
+    } else if (num_cpus > 0) {
+      part_cpus.push_back(cpus_[i % num_cpus]);
+    }
+    parts.emplace_back(std::make_unique<ThreadBudget>(part_threads, part_cpus));
+  }
+  return parts;
+}
+
+ThreadBudget* ThreadBudget::Current() { return current_budget; }
+
+ThreadBudgetGuard::ThreadBudgetGuard(ThreadBudget* budget, bool pin_thread) : prev_budget_(current_budget) {
+  if (!budget) {
+    return;
+  }
+  current_budget = budget;
+  if (pin_thread && !budget->cpus().empty()) {
+#ifdef __linux__
+    prev_cpus_ = GetAffinity(pthread_self());
+    int ret    = SetAffinity(pthread_self(), budget->cpus());
+    if (ret != 0) {
+      LOG(WARNING) << "Failed to pin the thread to the cpus of its budget, error code: " << ret;
+      prev_cpus_.clear();
+    }
+#else
+    LOG_FIRST_N(WARNING, 1) << "Pinning the threads to their budgets is only supported on Linux";
+#endif
+  }
+}
+
+ThreadBudgetGuard::~ThreadBudgetGuard() {
+  current_budget = prev_budget_;
+#ifdef __linux__
+  if (!prev_cpus_.empty()) {
+    SetAffinity(pthread_self(), prev_cpus_);
+  }
+#endif
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
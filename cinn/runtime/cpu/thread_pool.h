@@ -0,0 +1,150 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+/**
+ * A pool of persistent threads to run the parallel lambdas of generated code, which avoids the fork/join of an OpenMP
+ * parallel region on every launch. The calling thread runs a share of the tasks itself, and the idle workers spin
+ * for a while before parking on a condition variable.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param num_threads The number of threads running a launch, including the calling thread.
+   * @param cpus The cpus to pin the workers to in turn, the workers are not pinned if it is empty.
+   * @param spin_count The number of polls of an idle worker before it parks.
+   */
+  explicit ThreadPool(int num_threads, const std::vector<int>& cpus = {}, int spin_count = 10000);
+  ~ThreadPool();
+
+  /**
+   * The global pool of max_concurrency() threads, whose workers are pinned to FLAGS_cinn_thread_pool_cpus.
+   */
+  static ThreadPool* Global();
+
+  /**
+   * Run \p flambda with the task ids [0, num_task) and wait for all of them. The tasks run sequentially on the
+   * calling thread if it is called inside a task or while the pool is running another launch.
+   * @param num_task The number of tasks, 0 means the number of threads of the pool.
+   */
+  int Launch(FCINNParallelLambda flambda, void* datas, int num_task);
+
+  int num_threads() const { return num_threads_; }
+
+  /**
+   * Parse a cpu list such as "0-3,8,10-11".
+   */
+  static std::vector<int> ParseCpuList(const std::string& cpu_list);
+
+ private:
+  void WorkerLoop(int worker_id);
+
+  // run the tasks of `worker_id` in the current launch, the tasks are dealt to the participants in turn
+  void RunTasks(int worker_id, int num_participants);
+
+  const int num_threads_;
+  const int spin_count_;
+  std::vector<std::thread> workers_;
+
+  // only one launch runs on the pool at a time
+  std::mutex launch_mtx_;
+  // the current launch, which is published by bumping generation_ together with its number of participants
+  FCINNParallelLambda flambda_ = nullptr;
+  void* datas_                 = nullptr;
+  int num_task_                = 0;
+  std::atomic<uint64_t> generation_{0};
+  // the number of workers which haven't finished the current launch
+  std::atomic<int> num_pending_{0};
+
+  // the parking of idle workers
+  std::mutex park_mtx_;
+  std::condition_variable park_cv_;
+  std::atomic<int> num_parked_{0};
+  std::atomic<bool> stop_{false};
+};
+
+/**
+ * A slice of the cores for a program or an execution context, so that several programs in one process share the
+ * machine without oversubscription. The parallel loops launched by a thread inside a ThreadBudgetGuard run on at most
+ * num_threads() threads including the launching one, on the pool of the slice whose workers are pinned to cpus() if
+ * the backend is thread_pool. Several threads launching within one budget should each take a part of it, see
+ * Partition.
+ */
+class ThreadBudget {
+ public:
+  /**
+   * @param num_threads The number of threads of the slice, 0 means the number of \p cpus.
+   * @param cpus The cpus of the slice, the threads are not pinned if it is empty.
+   */
+  explicit ThreadBudget(int num_threads, const std::vector<int>& cpus = {});
+
+  int num_threads() const { return num_threads_; }
+  const std::vector<int>& cpus() const { return cpus_; }
+
+  //! The thread pool of the slice, which is created on the first use.
+  ThreadPool* pool();
+
+  /**
+   * Split the slice into \p num_parts disjoint budgets, whose threads add up to num_threads() and whose cpus are
+   * contiguous ranges of cpus(). The parts are created once for each \p num_parts and live as long as the budget.
+   */
+  const std::vector<std::unique_ptr<ThreadBudget>>& Partition(int num_parts);
+
+  //! The budget of the current thread, nullptr if the thread is not inside any ThreadBudgetGuard.
+  static ThreadBudget* Current();
+
+ private:
+  int num_threads_;
+  std::vector<int> cpus_;
+  std::once_flag pool_flag_;
+  std::unique_ptr<ThreadPool> pool_;
+
+  std::mutex partition_mtx_;
+  std::map<int, std::vector<std::unique_ptr<ThreadBudget>>> partitions_;
+};
+
+/**
+ * Set the budget of the current thread during the lifetime of the guard, nullptr keeps the current one. If
+ * \p pin_thread is true, the current thread is also pinned to the cpus of the budget until the guard is destroyed.
+ */
+class ThreadBudgetGuard {
+ public:
+  explicit ThreadBudgetGuard(ThreadBudget* budget, bool pin_thread = false);
+  ~ThreadBudgetGuard();
+
+ private:
+  ThreadBudget* prev_budget_;
+  // the affinity of the current thread before pinning, empty if it is not pinned
+  std::vector<int> prev_cpus_;
+};
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
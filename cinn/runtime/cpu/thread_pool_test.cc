@@ -0,0 +1,213 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+struct Counters {
+  std::vector<std::atomic<int>> hits;
+  explicit Counters(int num_task) : hits(num_task) {
+    for (auto& hit : hits) hit = 0;
+  }
+};
+
+int CountTask(int task_id, int num_task, void* datas) {
+  auto* counters = reinterpret_cast<Counters*>(datas);
+  EXPECT_EQ(counters->hits.size(), num_task);
+  counters->hits[task_id]++;
+  return 0;
+}
+
+struct NestedDatas {
+  ThreadPool* pool;
+  Counters* inner;
+};
+
+int LaunchNested(int task_id, int num_task, void* datas) {
+  auto* nested = reinterpret_cast<NestedDatas*>(datas);
+  Counters counters(3);
+  nested->pool->Launch(&CountTask, &counters, 3);
+  for (auto& hit : counters.hits) {
+    EXPECT_EQ(hit, 1);
+  }
+  nested->inner->hits[task_id]++;
+  return 0;
+}
+
+struct Concurrency {
+  std::atomic<int> active{0};
+  std::atomic<int> max_active{0};
+};
+
+// record the number of tasks running at the same time
+int CountConcurrency(int task_id, int num_task, void* datas) {
+  auto* concurrency = reinterpret_cast<Concurrency*>(datas);
+  int active        = ++concurrency->active;
+  int max_active    = concurrency->max_active.load();
+  while (active > max_active && !concurrency->max_active.compare_exchange_weak(max_active, active)) {
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(200));
+  --concurrency->active;
+  return 0;
+}
+
+}  // namespace
+
+TEST(ThreadPool, ParseCpuList) {
+  ASSERT_EQ(ThreadPool::ParseCpuList(""), std::vector<int>());
+  ASSERT_EQ(ThreadPool::ParseCpuList("0-3,8,10-11"), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+}
+
+TEST(ThreadPool, Launch) {
+  ThreadPool pool(4, {}, 100);
+  // each task runs exactly once whether the tasks are fewer or more than the threads
+  for (int num_task : {1, 2, 4, 7, 64}) {
+    for (int repeat = 0; repeat < 20; ++repeat) {
+      Counters counters(num_task);
+      ASSERT_EQ(pool.Launch(&CountTask, &counters, num_task), 0);
+      for (auto& hit : counters.hits) {
+        ASSERT_EQ(hit, 1);
+      }
+    }
+  }
+  // 0 means all the threads of the pool
+  Counters counters(pool.num_threads());
+  pool.Launch(&CountTask, &counters, 0);
+  for (auto& hit : counters.hits) {
+    ASSERT_EQ(hit, 1);
+  }
+}
+
+TEST(ThreadPool, NestedAndConcurrentLaunch) {
+  ThreadPool pool(4, {}, 0);
+  Counters inner(5);
+  NestedDatas nested{&pool, &inner};
+  pool.Launch(&LaunchNested, &nested, 5);
+  for (auto& hit : inner.hits) {
+    ASSERT_EQ(hit, 1);
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&pool] {
+      for (int repeat = 0; repeat < 50; ++repeat) {
+        Counters counters(16);
+        pool.Launch(&CountTask, &counters, 16);
+        for (auto& hit : counters.hits) {
+          ASSERT_EQ(hit, 1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(ThreadBudget, Guard) {
+  ASSERT_EQ(ThreadBudget::Current(), nullptr);
+  ThreadBudget outer(0, {0, 1});
+  ASSERT_EQ(outer.num_threads(), 2);
+  ThreadBudget inner(3);
+  {
+    ThreadBudgetGuard outer_guard(&outer);
+    ASSERT_EQ(ThreadBudget::Current(), &outer);
+    {
+      ThreadBudgetGuard inner_guard(&inner);
+      ASSERT_EQ(ThreadBudget::Current(), &inner);
+      // a null budget keeps the current one
+      ThreadBudgetGuard null_guard(nullptr);
+      ASSERT_EQ(ThreadBudget::Current(), &inner);
+    }
+    ASSERT_EQ(ThreadBudget::Current(), &outer);
+    // the budget is per thread
+    std::thread([] { ASSERT_EQ(ThreadBudget::Current(), nullptr); }).join();
+  }
+  ASSERT_EQ(ThreadBudget::Current(), nullptr);
+
+  // the pool of a budget runs all its threads for a launch of 0 tasks
+  ASSERT_EQ(inner.pool(), inner.pool());
+  ASSERT_EQ(inner.pool()->num_threads(), 3);
+  Counters counters(3);
+  inner.pool()->Launch(&CountTask, &counters, 0);
+  for (auto& hit : counters.hits) {
+    ASSERT_EQ(hit, 1);
+  }
+}
+
+TEST(ThreadBudget, Partition) {
+  ThreadBudget budget(4, {0, 1, 2, 3});
+  auto& halves = budget.Partition(2);
+  ASSERT_EQ(halves.size(), 2);
+  ASSERT_EQ(halves[0]->num_threads(), 2);
+  ASSERT_EQ(halves[0]->cpus(), std::vector<int>({0, 1}));
+  ASSERT_EQ(halves[1]->num_threads(), 2);
+  ASSERT_EQ(halves[1]->cpus(), std::vector<int>({2, 3}));
+  // the remainders go to the first parts
+  auto& thirds = budget.Partition(3);
+  ASSERT_EQ(thirds.size(), 3);
+  ASSERT_EQ(thirds[0]->num_threads(), 2);
+  ASSERT_EQ(thirds[0]->cpus(), std::vector<int>({0, 1}));
+  ASSERT_EQ(thirds[1]->num_threads(), 1);
+  ASSERT_EQ(thirds[1]->cpus(), std::vector<int>({2}));
+  ASSERT_EQ(thirds[2]->num_threads(), 1);
+  ASSERT_EQ(thirds[2]->cpus(), std::vector<int>({3}));
+  // the parts are created once
+  ASSERT_EQ(&budget.Partition(2), &halves);
+  ASSERT_EQ(budget.Partition(2)[0].get(), halves[0].get());
+
+  // the parts share the cpus if there are fewer cpus than parts
+  ThreadBudget few_cpus(4, {5});
+  for (auto& part : few_cpus.Partition(4)) {
+    ASSERT_EQ(part->num_threads(), 1);
+    ASSERT_EQ(part->cpus(), std::vector<int>({5}));
+  }
+}
+
+TEST(ThreadBudget, PartitionBoundsConcurrency) {
+  // two executors launching parallel loops in their own halves of a budget run at most 4 tasks at the same time,
+  // while they would run 5 if both launched on the pool of the whole budget, as the busy one runs sequentially
+  ThreadBudget budget(4);
+  Concurrency concurrency;
+  std::vector<std::thread> executors;
+  for (int slot = 0; slot < 2; ++slot) {
+    executors.emplace_back([&budget, &concurrency, slot] {
+      ThreadBudgetGuard guard(budget.Partition(2)[slot].get(), true);
+      for (int repeat = 0; repeat < 20; ++repeat) {
+        ThreadBudget::Current()->pool()->Launch(&CountConcurrency, &concurrency, 0);
+      }
+    });
+  }
+  for (auto& executor : executors) {
+    executor.join();
+  }
+  ASSERT_GT(concurrency.max_active.load(), 0);
+  ASSERT_LE(concurrency.max_active.load(), budget.num_threads());
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
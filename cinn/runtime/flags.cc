@@ -26,12 +26,64 @@ DEFINE_bool(cinn_cudnn_deterministic,
 #endif
 
 using ::GFLAGS_NAMESPACE::BoolFromEnv;
+using ::GFLAGS_NAMESPACE::Int32FromEnv;
 using ::GFLAGS_NAMESPACE::StringFromEnv;
 
 DEFINE_int32(cinn_parallel_compile_size,
              0,
              "When use parallel compile, set the number of group compiled by each thread.");
 
+DEFINE_bool(cinn_parallel_compile_share_engine,
+            BoolFromEnv("FLAGS_cinn_parallel_compile_share_engine", false),
+            "Whether all the tasks of parallel compile link their modules into one shared JIT engine rather than "
+            "creating an engine for each task.");
+
+DEFINE_int32(cinn_program_executor_threads,
+             Int32FromEnv("FLAGS_cinn_program_executor_threads", 0),
+             "The number of threads used to run independent instructions of a host Program concurrently, "
+             "0 or 1 means running instructions sequentially.");
+
+DEFINE_int32(cinn_task_pool_threads,
+             Int32FromEnv("FLAGS_cinn_task_pool_threads", 0),
+             "The number of threads of the global task pool which runs the compiler-side parallel jobs such as "
+             "parallel compiling and measuring, 0 means the number of hardware threads.");
+
+DEFINE_bool(cinn_x86_caching_allocator,
+            BoolFromEnv("FLAGS_cinn_x86_caching_allocator", false),
+            "Whether use the caching memory pool rather than the system allocator for X86 buffers.");
+
+DEFINE_bool(cinn_x86_caching_allocator_huge_page,
+            BoolFromEnv("FLAGS_cinn_x86_caching_allocator_huge_page", false),
+            "Whether back the large blocks of the X86 caching memory pool by transparent huge pages.");
+
+DEFINE_int32(cinn_x86_caching_allocator_max_cached_mb,
+             Int32FromEnv("FLAGS_cinn_x86_caching_allocator_max_cached_mb", 1024),
+             "The maximum megabytes of free blocks kept in the global pool of the X86 caching memory pool.");
+
+DEFINE_string(cinn_parallel_launch_backend,
+              StringFromEnv("FLAGS_cinn_parallel_launch_backend", "openmp"),
+              "The backend to run the parallel loops of X86 code, openmp or thread_pool. The thread_pool backend keeps "
+              "persistent workers rather than opening an OpenMP parallel region on every launch.");
+
+DEFINE_string(cinn_thread_pool_cpus,
+              StringFromEnv("FLAGS_cinn_thread_pool_cpus", ""),
+              "The cpu list such as 0-3,8 to pin the workers of the thread_pool parallel launch backend, the workers "
+              "are not pinned if it is empty.");
+
+DEFINE_int32(cinn_thread_pool_spin_count,
+             Int32FromEnv("FLAGS_cinn_thread_pool_spin_count", 10000),
+             "The number of polls of an idle worker of the thread_pool parallel launch backend before it parks.");
+
+DEFINE_bool(cinn_mmap_params,
+            BoolFromEnv("FLAGS_cinn_mmap_params", true),
+            "Whether load the parameter files of paddle models by mapping them into memory, the host tensors whose data "
+            "is aligned point to the mapped pages directly rather than copying them.");
+
+DEFINE_int32(cinn_param_load_threads,
+             Int32FromEnv("FLAGS_cinn_param_load_threads", 8),
+             "The maximum number of threads loading the parameter files of a paddle model which is not combined "
+             "concurrently, which bounds the concurrent I/O requests.");
+
 DEFINE_bool(cinn_open_fusion_optimize,
             BoolFromEnv("FLAGS_cinn_open_fusion_optimize", true),
             "Whether use the op_fusion optimization.");
@@ -41,6 +93,15 @@ DEFINE_bool(cinn_use_new_fusion_pass,
             BoolFromEnv("FLAGS_cinn_use_new_fusion_pass", true),
             "Whether use the new op_fusion and fusion_merge pass.");
 
+DEFINE_bool(cinn_share_identical_groups,
+            BoolFromEnv("FLAGS_cinn_share_identical_groups", true),
+            "Whether the fusion groups of a same structure share one lowered and compiled function.");
+
+DEFINE_bool(cinn_fold_constant_subgraphs,
+            BoolFromEnv("FLAGS_cinn_fold_constant_subgraphs", true),
+            "Whether evaluate the subgraphs computed from the loaded constants only at compile time and replace them by "
+            "new constants, rather than running them by PreRun.");
+
 DEFINE_bool(cinn_use_fill_constant_folding,
             BoolFromEnv("FLAGS_cinn_use_fill_constant_folding", false),
             "Whether use the FillConstantFolding pass.");
@@ -70,6 +131,21 @@ DEFINE_string(cinn_source_code_save_path,
               StringFromEnv("FLAGS_cinn_source_code_save_path", ""),
               "Specify the directory path of generated source code, which is used for debug.");
 
+DEFINE_string(cinn_host_trace_path,
+              StringFromEnv("FLAGS_cinn_host_trace_path", ""),
+              "Specify the file path to export the host events of instructions and compiler phases as Chrome trace "
+              "JSON when the process exits, which is used for performance analysis.");
+
+DEFINE_string(cinn_jit_cache_dir,
+              StringFromEnv("FLAGS_cinn_jit_cache_dir", ""),
+              "Specify the directory to cache the object code of the X86 JIT across processes, the cache is disabled "
+              "if it is empty.");
+
+DEFINE_int32(cinn_jit_cache_max_mb,
+             Int32FromEnv("FLAGS_cinn_jit_cache_max_mb", 1024),
+             "The maximum megabytes of the objects kept in the JIT cache directory, the least recently used ones are "
+             "evicted beyond it.");
+
 DEFINE_bool(enable_auto_tuner, BoolFromEnv("FLAGS_enable_auto_tuner", false), "Whether enable auto tuner.");
 
 DEFINE_bool(auto_schedule_use_cost_model,
@@ -46,6 +46,7 @@ static const char* buffer_create_default = "cinn_buffer_new_default";
 
 static const char* buffer_get_data_handle       = "cinn_buffer_get_data_handle";
 static const char* buffer_get_data_const_handle = "cinn_buffer_get_data_const_handle";
+static const char* buffer_get_dim               = "cinn_buffer_get_dim";
 
 //! Buffer load an element of some primitive type
 // @{
@@ -84,6 +85,8 @@ static const char* cuda_sync_threads = "__syncthreads";
 
 static const char* parallel_launch = "cinn_backend_parallel_launch";
 
+static const char* parallel_next_chunk = "cinn_backend_parallel_next_chunk";
+
 }  // namespace intrinsic
 
 /**
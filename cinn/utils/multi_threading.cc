@@ -16,12 +16,15 @@
 
 #include <glog/logging.h>
 
-#include <future>
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
-#include <utility>
-#include <vector>
 
 #include "cinn/utils/string.h"
+#include "cinn/utils/task_pool.h"
 
 namespace cinn {
 namespace utils {
@@ -57,40 +60,57 @@ void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_
     return counter;
   };
 
-  std::vector<std::future<int>> futures;
-  std::vector<std::thread> threads;
-  // The first thread runs inplace, and other `num_threads - 1` threads launched
-  // with std::future to run asynchronously
-  if (num_threads > 1) {
-    futures.reserve(num_threads - 1);
-    threads.reserve(num_threads - 1);
-    for (int tid = 1; tid < num_threads; ++tid) {
-      std::packaged_task<int(int)> task(worker);
-      futures.emplace_back(task.get_future());
-      threads.emplace_back(std::move(task), tid);
-    }
-  }
-
-  // wait results and catch exceptions
-  try {
-    int tid     = 0;
-    int counter = worker(tid);
-    VLOG(4) << "Thread-0  process " << counter << " tasks.";
-
-    for (auto&& future : futures) {
-      counter = future.get();
-      ++tid;
+  // The first thread runs inplace, and other `num_threads - 1` helpers run on the global task pool. A helper which
+  // is not started until the jobs are done by others quits immediately, so the caller only waits for the started
+  // helpers, which keeps nested parallel runs from waiting for the tasks queued behind themselves.
+  struct HelperState {
+    std::mutex mtx;
+    std::condition_variable cv;
+    int num_running = 0;
+    bool finished   = false;
+    std::string error;
+  };
+  auto state = std::make_shared<HelperState>();
+  auto run   = [&worker, &state](int tid) {
+    try {
+      int counter = worker(tid);
       VLOG(4) << "Thread-" << tid << " process " << counter << " tasks.";
+    } catch (const std::exception& e) {
+      std::lock_guard<std::mutex> lock(state->mtx);
+      state->error = e.what();
     }
-  } catch (const std::exception& e) {
-    LOG(FATAL) << "parallel_run incurs error: " << e.what();
+  };
+  auto* pool = TaskPool::Global();
+  for (int tid = 1; tid < std::min(num_threads, pool->num_threads() + 1); ++tid) {
+    pool->Enqueue([state, &run, tid] {
+      {
+        std::lock_guard<std::mutex> lock(state->mtx);
+        if (state->finished) {
+          return;
+        }
+        ++state->num_running;
+      }
+      run(tid);
+      std::lock_guard<std::mutex> lock(state->mtx);
+      if (--state->num_running == 0) {
+        state->cv.notify_all();
+      }
+    });
   }
+  run(0);
 
-  // join threads
-  for (auto&& thread : threads) {
-    thread.join();
+  // wait the started helpers and report their exceptions
+  std::unique_lock<std::mutex> lock(state->mtx);
+  state->finished = true;
+  state->cv.wait(lock, [&state] { return state->num_running == 0; });
+  if (!state->error.empty()) {
+    LOG(FATAL) << "parallel_run incurs error: " << state->error;
   }
 }
 
+void parallel_for(int begin, int end, const WorkerFuncType& fn, int num_threads) {
+  parallel_run(fn, SequenceDispatcher(begin, end), num_threads);
+}
+
 }  // namespace utils
 }  // namespace cinn
@@ -51,12 +51,19 @@ class SequenceDispatcher : public JobDispatcher {
 };
 
 /**
- * \brief A general function to run a batch of jobs in parallel
+ * \brief A general function to run a batch of jobs in parallel, the calling thread runs jobs together with at most
+ * `num_threads - 1` threads of the global TaskPool
  * \param fn A instance of WorkerFuncType, which defines how to complete a specified job
  * \param dispatcher A instance of JobDispatcher, which pops index of the next job
  * \param num_threads The number of threads used to run jobs, -1 means utilizing the maximum limit of hardware
  */
 void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_threads = -1);
 
+/**
+ * \brief Run `fn` on every index in the extent of [begin, end) in parallel
+ * \param num_threads The number of threads used to run jobs, -1 means utilizing the maximum limit of hardware
+ */
+void parallel_for(int begin, int end, const WorkerFuncType& fn, int num_threads = -1);
+
 }  // namespace utils
 }  // namespace cinn
@@ -14,6 +14,16 @@
 
 #include "cinn/utils/profiler.h"
 
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
 #endif
@@ -24,9 +34,189 @@
 #include "cinn/backends/cuda_util.h"
 #endif
 
+DECLARE_string(cinn_host_trace_path);
+
 namespace cinn {
 namespace utils {
 
+namespace {
+
+// the number of events kept by the ring buffer of each thread
+constexpr uint64_t kEventsPerThread = 1 << 14;
+// the number of events kept for the exited threads, the oldest ones are dropped beyond it
+constexpr size_t kMaxRetiredEvents = 1 << 16;
+
+std::atomic<uint64_t> next_thread_id{0};
+
+const std::chrono::steady_clock::time_point& RecorderEpoch() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return epoch;
+}
+
+void AppendJsonString(const char* str, std::ostringstream* os) {
+  *os << '"';
+  for (const char* p = str; *p; ++p) {
+    if (*p == '"' || *p == '\\') {
+      *os << '\\' << *p;
+    } else if (static_cast<unsigned char>(*p) >= 0x20) {
+      *os << *p;
+    }
+  }
+  *os << '"';
+}
+
+}  // namespace
+
+struct HostEventRecorder::ThreadBuffer {
+  explicit ThreadBuffer(uint64_t id) : events(kEventsPerThread), count(0), thread_id(id) {}
+
+  std::vector<HostEvent> events;
+  // the number of events ever recorded, only the owner thread increases it
+  std::atomic<uint64_t> count;
+  uint64_t thread_id;
+};
+
+HostEventRecorder& HostEventRecorder::Instance() {
+  static HostEventRecorder recorder;
+  return recorder;
+}
+
+HostEventRecorder::HostEventRecorder() : export_path_(FLAGS_cinn_host_trace_path) {
+  RecorderEpoch();
+  if (!export_path_.empty()) {
+    Start();
+  }
+}
+
+HostEventRecorder::~HostEventRecorder() {
+  if (!export_path_.empty()) {
+    Stop();
+    ExportChromeTrace(export_path_);
+  }
+}
+
+uint64_t HostEventRecorder::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - RecorderEpoch())
+      .count();
+}
+
+HostEventRecorder::ThreadBuffer* HostEventRecorder::GetThreadBuffer() {
+  // the owner returns the buffer to the recorder when the thread exits
+  struct BufferOwner {
+    HostEventRecorder* recorder = nullptr;
+    ThreadBuffer* buffer        = nullptr;
+    ~BufferOwner() {
+      if (buffer) {
+        recorder->ReleaseThreadBuffer(buffer);
+      }
+    }
+  };
+  thread_local BufferOwner owner;
+  if (!owner.buffer) {
+    uint64_t thread_id = next_thread_id.fetch_add(1);
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (free_buffers_.empty()) {
+      buffers_.emplace_back(std::make_shared<ThreadBuffer>(thread_id));
+      owner.buffer = buffers_.back().get();
+    } else {
+      owner.buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+      owner.buffer->thread_id = thread_id;
+    }
+    owner.recorder = this;
+  }
+  return owner.buffer;
+}
+
+void HostEventRecorder::ReleaseThreadBuffer(ThreadBuffer* buffer) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  uint64_t count = buffer->count.load(std::memory_order_acquire);
+  uint64_t begin = count > kEventsPerThread ? count - kEventsPerThread : 0;
+  for (uint64_t idx = begin; idx < count; ++idx) {
+    retired_events_.push_back(buffer->events[idx % kEventsPerThread]);
+  }
+  while (retired_events_.size() > kMaxRetiredEvents) {
+    retired_events_.pop_front();
+  }
+  buffer->count.store(0, std::memory_order_release);
+  free_buffers_.push_back(buffer);
+}
+
+void HostEventRecorder::Record(const HostEvent& event) {
+  auto* buffer = GetThreadBuffer();
+  uint64_t idx = buffer->count.load(std::memory_order_relaxed);
+  auto& slot     = buffer->events[idx % kEventsPerThread];
+  slot           = event;
+  slot.thread_id = buffer->thread_id;
+  buffer->count.store(idx + 1, std::memory_order_release);
+}
+
+std::vector<HostEvent> HostEventRecorder::GatherEvents() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::vector<HostEvent> events(retired_events_.begin(), retired_events_.end());
+  for (auto& buffer : buffers_) {
+    uint64_t count = buffer->count.load(std::memory_order_acquire);
+    uint64_t begin = count > kEventsPerThread ? count - kEventsPerThread : 0;
+    for (uint64_t idx = begin; idx < count; ++idx) {
+      events.push_back(buffer->events[idx % kEventsPerThread]);
+    }
+  }
+  std::sort(events.begin(), events.end(), [](const HostEvent& a, const HostEvent& b) {
+    return a.start_ns < b.start_ns;
+  });
+  return events;
+}
+
+void HostEventRecorder::Clear() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  for (auto& buffer : buffers_) {
+    buffer->count.store(0, std::memory_order_release);
+  }
+  retired_events_.clear();
+}
+
+size_t HostEventRecorder::NumThreadBuffers() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return buffers_.size();
+}
+
+std::string HostEventRecorder::ChromeTraceJson() const {
+  auto pid = getpid();
+  std::ostringstream os;
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  for (auto& event : GatherEvents()) {
+    os << (first ? "\n" : ",\n") << "{\"name\":";
+    AppendJsonString(event.name, &os);
+    // timestamps of trace_event are in microseconds
+    os << ",\"cat\":\"cinn\",\"ph\":\"X\",\"ts\":" << event.start_ns / 1000.0
+       << ",\"dur\":" << (event.end_ns - event.start_ns) / 1000.0 << ",\"pid\":" << pid
+       << ",\"tid\":" << event.thread_id << ",\"args\":{\"bytes\":" << event.arg_bytes << "}}";
+    first = false;
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  return os.str();
+}
+
+void HostEventRecorder::ExportChromeTrace(const std::string& path) const {
+  std::ofstream of(path, std::ofstream::out | std::ofstream::trunc);
+  CHECK(of.is_open()) << "Failed to open " << path;
+  of << ChromeTraceJson();
+}
+
+void RecordEvent::Begin(const char* name, uint64_t arg_bytes) {
+  std::strncpy(event_.name, name, HostEvent::kMaxNameLen - 1);
+  event_.name[HostEvent::kMaxNameLen - 1] = '\0';
+  event_.arg_bytes                        = arg_bytes;
+  event_.start_ns                         = HostEventRecorder::NowNs();
+  recording_                              = true;
+}
+
+void RecordEvent::End() {
+  event_.end_ns = HostEventRecorder::NowNs();
+  HostEventRecorder::Instance().Record(event_);
+}
+
 void SynchronizeAllDevice() {
 #ifdef CINN_WITH_CUDA
   int current_device_id;
@@ -46,12 +236,14 @@ void ProfilerStart() {
   CUDA_CALL(cudaProfilerStart());
   SynchronizeAllDevice();
 #endif
+  HostEventRecorder::Instance().Start();
 }
 
 void ProfilerStop() {
 #ifdef CINN_WITH_CUDA
   CUDA_CALL(cudaProfilerStop());
 #endif
+  HostEventRecorder::Instance().Stop();
 }
 
 void ProfilerRangePush(const std::string& name) {
@@ -14,7 +14,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
@@ -23,22 +29,111 @@
 namespace cinn {
 namespace utils {
 
+//! A span of time on the host, such as running an instruction or a compiler phase.
+struct HostEvent {
+  static constexpr int kMaxNameLen = 64;
+
+  char name[kMaxNameLen];
+  uint64_t start_ns;
+  uint64_t end_ns;
+  uint64_t thread_id;
+  uint64_t arg_bytes;
+};
+
+/**
+ * HostEventRecorder collects the HostEvents of all threads. Each thread appends its events to a private ring buffer
+ * without any lock, and the oldest events are overwritten once the buffer is full. When a thread exits, its events are
+ * moved to a bounded list of retired events and its buffer is reused by the next new thread, so that short-lived
+ * threads do not grow the memory. The events should be gathered or cleared after recording is stopped.
+ */
+class HostEventRecorder {
+ public:
+  static HostEventRecorder& Instance();
+
+  static bool Enabled() { return Instance().enabled_.load(std::memory_order_relaxed); }
+
+  //! The nanoseconds elapsed since the recorder was created.
+  static uint64_t NowNs();
+
+  void Start() { enabled_.store(true, std::memory_order_relaxed); }
+  void Stop() { enabled_.store(false, std::memory_order_relaxed); }
+
+  //! Append an event to the ring buffer of the calling thread.
+  void Record(const HostEvent& event);
+
+  //! Get the recorded events of all threads sorted by their start time.
+  std::vector<HostEvent> GatherEvents() const;
+
+  void Clear();
+
+  //! The number of ring buffers, which is the most threads recording at the same time.
+  size_t NumThreadBuffers() const;
+
+  //! Dump the recorded events in the Chrome trace_event format, which can be viewed by chrome://tracing.
+  std::string ChromeTraceJson() const;
+  void ExportChromeTrace(const std::string& path) const;
+
+  ~HostEventRecorder();
+
+ private:
+  struct ThreadBuffer;
+
+  HostEventRecorder();
+
+  ThreadBuffer* GetThreadBuffer();
+
+  // move the events of an exiting thread to retired_events_ and put its buffer into free_buffers_
+  void ReleaseThreadBuffer(ThreadBuffer* buffer);
+
+  std::atomic<bool> enabled_{false};
+  // the path to export events when the process exits, it is specified by FLAGS_cinn_host_trace_path
+  std::string export_path_;
+
+  // guard the buffers and the retired events, which are only touched when a thread starts or exits recording
+  mutable std::mutex mtx_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  std::vector<ThreadBuffer*> free_buffers_;
+  std::deque<HostEvent> retired_events_;
+};
+
 class RecordEvent {
  public:
-  RecordEvent(const std::string& name) {
+  RecordEvent(const std::string& name, uint64_t arg_bytes = 0) : RecordEvent(name.c_str(), arg_bytes) {}
+
+  RecordEvent(const char* name, uint64_t arg_bytes = 0) {
 #ifdef CINN_WITH_NVTX
-    nvtxRangePushA(name.c_str());
+    nvtxRangePushA(name);
 #endif
+    if (HostEventRecorder::Enabled()) {
+      Begin(name, arg_bytes);
+    }
   }
+
   ~RecordEvent() {
 #ifdef CINN_WITH_NVTX
     nvtxRangePop();
 #endif
+    if (recording_) {
+      End();
+    }
   }
+
+  //! Set the bytes of the arguments if they are unknown on construction.
+  void SetArgBytes(uint64_t arg_bytes) { event_.arg_bytes = arg_bytes; }
+
+  bool recording() const { return recording_; }
+
+ private:
+  void Begin(const char* name, uint64_t arg_bytes);
+  void End();
+
+  bool recording_{false};
+  HostEvent event_;
 };
 
 void SynchronizeAllDevice();
 
+//! Start the profiler of devices and the HostEventRecorder.
 void ProfilerStart();
 
 void ProfilerStop();
@@ -0,0 +1,119 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+TEST(HostEventRecorder, RecordEvents) {
+  auto& recorder = HostEventRecorder::Instance();
+  recorder.Clear();
+  {
+    // nothing is recorded before started
+    RecordEvent record("not_recorded");
+    ASSERT_FALSE(record.recording());
+  }
+
+  recorder.Start();
+  auto worker_fn = [](int index) {
+    for (int i = 0; i < 10; ++i) {
+      RecordEvent record("event_" + std::to_string(index), 1024);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(worker_fn, i);
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  recorder.Stop();
+
+  auto events = recorder.GatherEvents();
+  ASSERT_EQ(events.size(), 40UL);
+  std::set<uint64_t> thread_ids;
+  for (int i = 0; i < events.size(); ++i) {
+    ASSERT_LE(events[i].start_ns, events[i].end_ns);
+    ASSERT_EQ(events[i].arg_bytes, 1024UL);
+    if (i > 0) {
+      ASSERT_LE(events[i - 1].start_ns, events[i].start_ns);
+    }
+    thread_ids.insert(events[i].thread_id);
+  }
+  ASSERT_EQ(thread_ids.size(), 4UL);
+
+  auto json = recorder.ChromeTraceJson();
+  ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\":\"event_3\""), std::string::npos);
+  ASSERT_EQ(json.find("not_recorded"), std::string::npos);
+
+  recorder.Clear();
+  ASSERT_TRUE(recorder.GatherEvents().empty());
+}
+
+TEST(HostEventRecorder, RingBufferOverwrite) {
+  auto& recorder = HostEventRecorder::Instance();
+  recorder.Clear();
+  recorder.Start();
+  // keep the latest events once the ring buffer of the thread is full
+  std::thread worker([] {
+    for (int i = 0; i < (1 << 15); ++i) {
+      RecordEvent record(i < (1 << 14) ? "old" : "new");
+    }
+  });
+  worker.join();
+  recorder.Stop();
+
+  auto events = recorder.GatherEvents();
+  ASSERT_EQ(events.size(), 1UL << 14);
+  for (auto& event : events) {
+    ASSERT_EQ(std::string(event.name), "new");
+  }
+  recorder.Clear();
+}
+
+TEST(HostEventRecorder, ReuseBuffersOfExitedThreads) {
+  auto& recorder = HostEventRecorder::Instance();
+  recorder.Clear();
+  recorder.Start();
+  // warm up a buffer for the threads started one after another
+  std::thread([] { RecordEvent record("warm_up"); }).join();
+  size_t num_buffers = recorder.NumThreadBuffers();
+  for (int i = 0; i < 16; ++i) {
+    std::thread([] { RecordEvent record("short_lived"); }).join();
+  }
+  recorder.Stop();
+
+  // the threads reuse the buffer of the exited ones, while the events of all of them are kept
+  ASSERT_EQ(recorder.NumThreadBuffers(), num_buffers);
+  auto events = recorder.GatherEvents();
+  ASSERT_EQ(events.size(), 17UL);
+  std::set<uint64_t> thread_ids;
+  for (auto& event : events) {
+    thread_ids.insert(event.thread_id);
+  }
+  ASSERT_EQ(thread_ids.size(), 17UL);
+  recorder.Clear();
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,123 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/task_pool.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+
+DECLARE_int32(cinn_task_pool_threads);
+
+namespace cinn {
+namespace utils {
+
+namespace {
+// the pool and the id of the current thread if it is a worker
+thread_local const TaskPool* current_pool = nullptr;
+thread_local int current_worker_id        = -1;
+}  // namespace
+
+TaskPool::TaskPool(int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    queues_.emplace_back(std::make_unique<TaskQueue>());
+  }
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&TaskPool::WorkerLoop, this, i);
+  }
+  VLOG(3) << "Create a task pool of " << num_threads << " threads";
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+TaskPool* TaskPool::Global() {
+  static TaskPool pool(FLAGS_cinn_task_pool_threads);
+  return &pool;
+}
+
+void TaskPool::Enqueue(std::function<void()> task) {
+  int queue_id = current_pool == this ? current_worker_id : next_queue_.fetch_add(1) % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue_id]->mtx);
+    queues_[queue_id]->tasks.emplace_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    ++num_pending_;
+  }
+  cv_.notify_one();
+}
+
+std::function<void()> TaskPool::TakeTask(int worker_id) {
+  // the latest task of its own queue is the hottest in cache
+  {
+    auto& queue = *queues_[worker_id];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    if (!queue.tasks.empty()) {
+      auto task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return task;
+    }
+  }
+  // steal the earliest task of the others, a scan may miss the claimed task when other workers take tasks at the
+  // same time, so scan again until it is found
+  for (int round = 0;; ++round) {
+    for (int i = 1; i <= queues_.size(); ++i) {
+      auto& queue = *queues_[(worker_id + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mtx);
+      if (!queue.tasks.empty()) {
+        auto task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return task;
+      }
+    }
+    if (round > 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void TaskPool::WorkerLoop(int worker_id) {
+  current_pool      = this;
+  current_worker_id = worker_id;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this] { return stop_ || num_pending_ > 0; });
+      if (num_pending_ == 0) {
+        return;
+      }
+      --num_pending_;
+    }
+    auto task = TakeTask(worker_id);
+    task();
+  }
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,89 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+/**
+ * A pool of persistent threads for the compiler-side parallelism such as parallel compiling and measuring, so that
+ * the repeated parallel runs don't pay for creating threads every time.
+ *
+ * Every worker has its own task queue. A task submitted from a worker is pushed into the queue of the worker and the
+ * one from other threads into the queues in turn. A worker takes the latest task of its own queue first, and steals
+ * the earliest task of the other queues when its own one is empty.
+ */
+class TaskPool {
+ public:
+  //! @param num_threads The number of the workers, 0 means the number of hardware threads.
+  explicit TaskPool(int num_threads);
+  ~TaskPool();
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  //! The pool shared by the whole process, whose size is FLAGS_cinn_task_pool_threads.
+  static TaskPool* Global();
+
+  int num_threads() const { return workers_.size(); }
+
+  //! Run \p task on a worker asynchronously, the task should not throw.
+  void Enqueue(std::function<void()> task);
+
+  //! Run \p fn on a worker asynchronously, the returned future gets the result or the exception of \p fn.
+  template <typename F>
+  std::future<typename std::result_of<F()>::type> Submit(F&& fn) {
+    using ResultType = typename std::result_of<F()>::type;
+    auto task        = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(fn));
+    auto future      = task->get_future();
+    Enqueue([task] { (*task)(); });
+    return future;
+  }
+
+ private:
+  struct TaskQueue {
+    std::mutex mtx;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void WorkerLoop(int worker_id);
+  // take a task for the worker, which must exist as the worker has claimed it from num_pending_
+  std::function<void()> TakeTask(int worker_id);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+  // the queue for the next task submitted from a thread out of the pool
+  std::atomic<unsigned> next_queue_{0};
+
+  // the number of tasks in the queues which are not claimed by any worker
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  int num_pending_ = 0;
+  bool stop_       = false;
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/task_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "cinn/utils/multi_threading.h"
+
+namespace cinn {
+namespace utils {
+
+TEST(TaskPool, Submit) {
+  TaskPool pool(3);
+  ASSERT_EQ(pool.num_threads(), 3);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 100; ++i) {
+    futures.emplace_back(pool.Submit([i] { return i * i; }));
+  }
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(futures[i].get(), i * i);
+  }
+  // the exception of a task is passed to its future
+  auto error = pool.Submit([]() -> int { throw std::runtime_error("task failed"); });
+  ASSERT_THROW(error.get(), std::runtime_error);
+}
+
+TEST(TaskPool, NestedSubmit) {
+  // the tasks submitted by a worker are taken by itself or stolen by the others
+  TaskPool pool(2);
+  std::atomic<int> counter{0};
+  std::vector<std::future<void>> outers;
+  for (int i = 0; i < 8; ++i) {
+    outers.emplace_back(pool.Submit([&pool, &counter] {
+      for (int j = 0; j < 8; ++j) {
+        pool.Enqueue([&counter] { ++counter; });
+      }
+    }));
+  }
+  for (auto& outer : outers) {
+    outer.get();
+  }
+  while (counter.load() < 64) {
+    std::this_thread::yield();
+  }
+  ASSERT_EQ(counter.load(), 64);
+}
+
+TEST(parallel_for, Nested) {
+  // nested parallel runs on the global pool finish even when all the workers are busy with the outer jobs
+  int num_outer = TaskPool::Global()->num_threads() + 2;
+  std::vector<std::vector<int>> results(num_outer, std::vector<int>(50, -1));
+  parallel_for(0, num_outer, [&results](int i) {
+    parallel_for(0, 50, [&results, i](int j) { results[i][j] = i + j; }, 4);
+  });
+  for (int i = 0; i < num_outer; ++i) {
+    for (int j = 0; j < 50; ++j) {
+      ASSERT_EQ(results[i][j], i + j);
+    }
+  }
+}
+
+}  // namespace utils
+}  // namespace cinn